@@ -0,0 +1,233 @@
+/**
+ * Bit-parallel engine for 9x9 Sudoku boards
+ * Christopher Shan(cshan1), Omar Shafie(oshafie)
+ *
+ * The whole state is a digit plane per number (81 bits, as three 27 bit
+ * bands of three rows), the cells still empty and the cells holding each
+ * number: about 250 bytes that are copied by value at each branch instead of
+ * allocating boards. Naked singles come out of bit-sliced once/twice counts
+ * over the planes, hidden singles out of every plane sliced into rows and
+ * boxes, with a once/twice count over its rows for the columns.
+ */
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdint.h>
+
+#include "board.h"
+
+//all the cells of a band, of one of its rows and of its first box
+#define BAND_CELLS 0x7FFFFFF
+#define ROW_CELLS 0x1FF
+#define BOX_CELLS 0x1C0E07
+
+struct Bitboard9 {
+  //candidate cells of every number, by band
+  uint32_t planes[9][3];
+  //cells holding every number, by band
+  uint32_t placed[9][3];
+  //cells not set yet, by band
+  uint32_t unsolved[3];
+  unsigned char values[81];
+};
+
+struct Bitboard9Tables {
+  //cells of every row, column and box, by band
+  uint32_t units[27][3];
+  //cells sharing a unit with every cell, by band
+  uint32_t peers[81][3];
+};
+
+static Bitboard9Tables bitboardTables;
+
+inline int bandOf(int i) { return i / 27; }
+inline uint32_t bandBit(int i) { return 1u << (i % 27); }
+
+inline void buildBitboardTables() {
+  Bitboard9Tables &t = bitboardTables;
+  memset(&t, 0, sizeof(t));
+  for (int i = 0; i < 81; i++) {
+    int row = i / 9;
+    int col = i % 9;
+    int box = (row / 3) * 3 + col / 3;
+    t.units[row][bandOf(i)] |= bandBit(i);
+    t.units[9 + col][bandOf(i)] |= bandBit(i);
+    t.units[18 + box][bandOf(i)] |= bandBit(i);
+  }
+  for (int i = 0; i < 81; i++) {
+    int row = i / 9;
+    int col = i % 9;
+    int box = (row / 3) * 3 + col / 3;
+    for (int b = 0; b < 3; b++) {
+      t.peers[i][b] = (t.units[row][b] | t.units[9 + col][b] | t.units[18 + box][b]);
+    }
+    t.peers[i][bandOf(i)] &= ~bandBit(i);
+  }
+}
+
+inline void bitboardPlace(Bitboard9 &s, int i, int d) {
+  //write number d+1 to cell i and remove it from the peers of the cell
+  const uint32_t *peers = bitboardTables.peers[i];
+  int b = bandOf(i);
+  uint32_t bit = bandBit(i);
+  for (int k = 0; k < 9; k++) s.planes[k][b] &= ~bit;
+  for (int x = 0; x < 3; x++) s.planes[d][x] &= ~peers[x];
+  s.placed[d][b] |= bit;
+  s.unsolved[b] &= ~bit;
+  s.values[i] = d + 1;
+}
+
+inline bool bitboardPropagate(Bitboard9 &s) {
+  //place naked and hidden singles until none are left, return false iff the board has no solution
+  bool changed = true;
+  while (changed) {
+    changed = false;
+
+    //naked singles: cells seen in exactly one plane
+    for (int b = 0; b < 3; b++) {
+      uint32_t once = 0;
+      uint32_t twice = 0;
+      for (int d = 0; d < 9; d++) {
+        twice |= once & s.planes[d][b];
+        once |= s.planes[d][b];
+      }
+      //an empty cell no number can go to
+      if (s.unsolved[b] & ~once) return false;
+      uint32_t singles = s.unsolved[b] & once & ~twice;
+      while (singles) {
+        int bit = __builtin_ctz(singles);
+        singles &= singles - 1;
+        int i = b * 27 + bit;
+        for (int d = 0; d < 9; d++) {
+          if (s.planes[d][b] & (1u << bit)) {
+            bitboardPlace(s, i, d);
+            changed = true;
+            break;
+          }
+        }
+      }
+    }
+    if (changed) continue;
+
+    //hidden singles: numbers only one cell of a row, column or box can take
+    for (int d = 0; d < 9; d++) {
+      const uint32_t *plane = s.planes[d];
+      const uint32_t *placed = s.placed[d];
+      //cells where d+1 is forced, by band
+      uint32_t forced[3] = {0, 0, 0};
+      //columns seen once and at least twice over the 9 rows, and columns holding d+1
+      uint32_t colOnce = 0;
+      uint32_t colTwice = 0;
+      uint32_t colPlaced = 0;
+      for (int b = 0; b < 3; b++) {
+        for (int k = 0; k < 3; k++) {
+          uint32_t row = (plane[b] >> (9 * k)) & ROW_CELLS;
+          uint32_t rowPlaced = (placed[b] >> (9 * k)) & ROW_CELLS;
+          //the number can't go anywhere on the row
+          if (!row && !rowPlaced) return false;
+          if (row && !(row & (row - 1))) forced[b] |= row << (9 * k);
+          colTwice |= colOnce & row;
+          colOnce |= row;
+          colPlaced |= rowPlaced;
+        }
+        for (int j = 0; j < 3; j++) {
+          uint32_t box = plane[b] & (BOX_CELLS << (3 * j));
+          if (!box && !(placed[b] & (BOX_CELLS << (3 * j)))) return false;
+          if (box && !(box & (box - 1))) forced[b] |= box;
+        }
+      }
+      if (ROW_CELLS & ~colOnce & ~colPlaced) return false;
+      uint32_t colSingles = colOnce & ~colTwice;
+      if (colSingles) {
+        uint32_t spread = colSingles | (colSingles << 9) | (colSingles << 18);
+        for (int b = 0; b < 3; b++) forced[b] |= plane[b] & spread;
+      }
+
+      /* the planes only lose cells as numbers are placed, so a forced cell
+         that is still a candidate is still the only one of its unit */
+      for (int b = 0; b < 3; b++) {
+        while (forced[b]) {
+          int bit = __builtin_ctz(forced[b]);
+          forced[b] &= forced[b] - 1;
+          if (plane[b] & (1u << bit)) {
+            bitboardPlace(s, b * 27 + bit, d);
+            changed = true;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+inline bool bitboardSearch(Bitboard9 &s) {
+  //return true iff s could be completed, leaving the solution in s
+  if (!bitboardPropagate(s)) return false;
+  if (!(s.unsolved[0] | s.unsolved[1] | s.unsolved[2])) return true;
+
+  //branch on a cell with two choices if there is one, otherwise on the first empty cell
+  int cell = -1;
+  for (int b = 0; b < 3 && cell < 0; b++) {
+    uint32_t once = 0;
+    uint32_t twice = 0;
+    uint32_t thrice = 0;
+    for (int d = 0; d < 9; d++) {
+      thrice |= twice & s.planes[d][b];
+      twice |= once & s.planes[d][b];
+      once |= s.planes[d][b];
+    }
+    uint32_t pairs = s.unsolved[b] & twice & ~thrice;
+    if (pairs) cell = b * 27 + __builtin_ctz(pairs);
+  }
+  for (int b = 0; b < 3 && cell < 0; b++) {
+    if (s.unsolved[b]) cell = b * 27 + __builtin_ctz(s.unsolved[b]);
+  }
+
+  int b = bandOf(cell);
+  uint32_t bit = bandBit(cell);
+  for (int d = 0; d < 9; d++) {
+    if (s.planes[d][b] & bit) {
+      Bitboard9 child = s;
+      bitboardPlace(child, cell, d);
+      if (bitboardSearch(child)) {
+        s = child;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+//only 9x9 boards have a bitboard engine
+template <int N>
+Board<N> *bitboardSolve(Board<N> *board) {
+  return NULL;
+}
+
+template <>
+inline Board<3> *bitboardSolve<3>(Board<3> *board) {
+  //fill in board and return it if it has a solution, NULL otherwise
+  buildBitboardTables();
+  Bitboard9 s;
+  memset(&s, 0, sizeof(s));
+  for (int d = 0; d < 9; d++) {
+    for (int b = 0; b < 3; b++) s.planes[d][b] = BAND_CELLS;
+  }
+  for (int b = 0; b < 3; b++) s.unsolved[b] = BAND_CELLS;
+  for (int i = 0; i < 81; i++) {
+    int num = board->values[i];
+    if (!num) continue;
+    //a given that clashes with an earlier one
+    if (!(s.planes[num - 1][bandOf(i)] & bandBit(i))) return NULL;
+    bitboardPlace(s, i, num - 1);
+  }
+
+  if (!bitboardSearch(s)) return NULL;
+  for (int i = 0; i < 81; i++) {
+    if (!board->values[i]) setValue(board, i, s.values[i]);
+  }
+  return board;
+}
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * Candidate bitmask helpers for the Sudoku solvers
+ * Christopher Shan(cshan1), Omar Shafie(oshafie)
+ *
+ * A candidate mask has bit (d-1) set iff the number d is still a choice for
+ * the cell. The mask type is a template parameter so that 9x9 to 25x25
+ * boards use a plain 32 bit word, 36x36 to 64x64 boards a 64 bit word, and
+ * anything larger a multi-word bitset.
+ */
+
+#ifndef BITMASK_H
+#define BITMASK_H
+
+#include <stdint.h>
+
+//multi-word bitset, used when the choices of a cell do not fit in a machine word
+template <int W>
+struct WideMask {
+  uint64_t word[W];
+
+  WideMask(uint64_t low = 0) {
+    word[0] = low;
+    for (int i = 1; i < W; i++) word[i] = 0;
+  }
+
+  explicit operator bool() const {
+    for (int i = 0; i < W; i++)
+      if (word[i]) return true;
+    return false;
+  }
+
+  WideMask operator&(const WideMask &other) const {
+    WideMask result;
+    for (int i = 0; i < W; i++) result.word[i] = word[i] & other.word[i];
+    return result;
+  }
+  WideMask operator|(const WideMask &other) const {
+    WideMask result;
+    for (int i = 0; i < W; i++) result.word[i] = word[i] | other.word[i];
+    return result;
+  }
+  WideMask operator^(const WideMask &other) const {
+    WideMask result;
+    for (int i = 0; i < W; i++) result.word[i] = word[i] ^ other.word[i];
+    return result;
+  }
+  WideMask operator~() const {
+    WideMask result;
+    for (int i = 0; i < W; i++) result.word[i] = ~word[i];
+    return result;
+  }
+  WideMask &operator&=(const WideMask &other) { return *this = *this & other; }
+  WideMask &operator|=(const WideMask &other) { return *this = *this | other; }
+  WideMask &operator^=(const WideMask &other) { return *this = *this ^ other; }
+
+  WideMask operator<<(int shift) const {
+    WideMask result;
+    int words = shift / 64;
+    int bits = shift % 64;
+    for (int i = W - 1; i >= 0; i--) {
+      uint64_t w = (i - words >= 0) ? word[i - words] << bits : 0;
+      if (bits && i - words - 1 >= 0) w |= word[i - words - 1] >> (64 - bits);
+      result.word[i] = w;
+    }
+    return result;
+  }
+
+  bool operator==(const WideMask &other) const {
+    for (int i = 0; i < W; i++)
+      if (word[i] != other.word[i]) return false;
+    return true;
+  }
+  bool operator!=(const WideMask &other) const { return !(*this == other); }
+};
+
+inline int popCount(uint32_t mask) { return __builtin_popcount(mask); }
+inline int popCount(uint64_t mask) { return __builtin_popcountll(mask); }
+template <int W>
+inline int popCount(const WideMask<W> &mask) {
+  int count = 0;
+  for (int i = 0; i < W; i++) count += __builtin_popcountll(mask.word[i]);
+  return count;
+}
+
+//narrowest candidate mask type that holds the given number of choices
+template <int Bits, bool Word = (Bits <= 32), bool DoubleWord = (Bits <= 64)>
+struct MaskFor { typedef WideMask<(Bits + 63) / 64> type; };
+template <int Bits, bool DoubleWord>
+struct MaskFor<Bits, true, DoubleWord> { typedef uint32_t type; };
+template <int Bits>
+struct MaskFor<Bits, false, true> { typedef uint64_t type; };
+
+//REQUIRES: mask != 0
+inline int lowestBit(uint32_t mask) { return __builtin_ctz(mask); }
+inline int lowestBit(uint64_t mask) { return __builtin_ctzll(mask); }
+template <int W>
+inline int lowestBit(const WideMask<W> &mask) {
+  for (int i = 0; i < W; i++)
+    if (mask.word[i]) return i * 64 + __builtin_ctzll(mask.word[i]);
+  return -1;
+}
+
+//true iff exactly one choice is set in the mask
+inline bool isSingle(uint32_t mask) { return mask && !(mask & (mask - 1)); }
+inline bool isSingle(uint64_t mask) { return mask && !(mask & (mask - 1)); }
+template <int W>
+inline bool isSingle(const WideMask<W> &mask) { return popCount(mask) == 1; }
+
+//the number a single-choice mask stands for
+template <typename Mask>
+inline int maskToDigit(const Mask &mask) { return lowestBit(mask) + 1; }
+
+template <typename Mask>
+inline Mask digitMask(int digit) { return Mask(1) << (digit - 1); }
+
+//all the numbers 1..boardSize
+template <typename Mask>
+inline Mask fullMask(int boardSize) {
+  if (boardSize >= (int)(8 * sizeof(Mask))) return ~Mask(0);
+  return ~(~Mask(0) << boardSize);
+}
+
+#endif
@@ -0,0 +1,554 @@
+/**
+ * Sudoku board representation shared by the OpenMP solvers
+ * Christopher Shan(cshan1), Omar Shafie(oshafie)
+ */
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <math.h>
+#include <omp.h>
+#include <string>
+#include <vector>
+
+#include "bitmask.h"
+#include "topology.h"
+
+//most threads the solvers serve, per thread state is indexed by the OpenMP thread number
+#define MAX_THREADS 512
+#define CACHE_LINE 64
+
+template <int N>
+struct Trail;
+
+/* board of n^2 x n^2 cells, with n fixed at compile time so that every loop
+   bound and index computation below is a constant the compiler can fold */
+template <int N>
+struct Board {
+  //n is square root of board size
+  static const int n = N;
+  static const int boardSize = N * N;
+  static const int totalSquares = boardSize * boardSize;
+  //narrowest bitvector type that holds all the choices of a cell
+  typedef typename MaskFor<boardSize>::type Mask;
+
+  //candidate mask of every cell
+  Mask options[totalSquares];
+  /* digit planes: bit c of planes[d][r] is set iff the empty cell on row r,
+     column c can still take the number d+1 */
+  Mask planes[boardSize][boardSize];
+  /* cells of every unit (as numbered in topology.h) that hold or can still
+     take every number, a unit is infeasible as soon as one count reaches 0 */
+  unsigned char positions[3 * boardSize][boardSize];
+  //empty cells of every unit
+  unsigned char unitEmpty[3 * boardSize];
+  /* empty cells by number of choices, as doubly linked lists ended by -1,
+     so that the search finds the most constrained cell without a scan */
+  short firstCell[boardSize + 1];
+  short nextCell[totalSquares];
+  short prevCell[totalSquares];
+  //changes to undo on backtrack, NULL when the board is not searched in place
+  Trail<N> *trail;
+  //real value of every cell, 0 if the value is not set yet
+  unsigned char values[totalSquares];
+  //number of cells whose value is not set yet, 0 iff the board is solved
+  int emptyCells;
+};
+
+/* log of the changes made to a board searched in place: choices removed from
+   a cell (num 0) and values written (removed 0), undone in reverse order */
+template <int N>
+struct Trail {
+  struct Change {
+    int cell;
+    int num;
+    typename Board<N>::Mask removed;
+  };
+  std::vector<Change> changes;
+};
+
+template <int N>
+Board<N> *allocBoard() {
+  Board<N> *board = (Board<N> *)calloc(1, sizeof(Board<N>));
+  memset(board->firstCell, -1, sizeof(board->firstCell));
+  return board;
+}
+
+/* boards of the search, cache line aligned and recycled through a free list
+   per thread. each pool sits on its own cache lines so that threads don't
+   share them, and keeps every board it allocated so that all of them can be
+   released once the search is over */
+template <int N>
+struct alignas(CACHE_LINE) BoardPool {
+  std::vector<Board<N> *> freeBoards;
+  std::vector<Board<N> *> allBoards;
+
+  static BoardPool<N> pools[MAX_THREADS];
+};
+
+template <int N>
+BoardPool<N> BoardPool<N>::pools[MAX_THREADS];
+
+template <int N>
+Board<N> *poolBoard() {
+  //a board from the free list of the calling thread, or a new one. exits if none can be allocated
+  BoardPool<N> &pool = BoardPool<N>::pools[omp_get_thread_num()];
+  if (!pool.freeBoards.empty()) {
+    Board<N> *board = pool.freeBoards.back();
+    pool.freeBoards.pop_back();
+    return board;
+  }
+  void *block;
+  size_t bytes = (sizeof(Board<N>) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+  if (posix_memalign(&block, CACHE_LINE, bytes)) {
+    //copyBoard() and the searches have no way to go on without the board
+    printf("Error: Out of memory for the boards of the search.\n");
+    exit(1);
+  }
+  pool.allBoards.push_back((Board<N> *)block);
+  return (Board<N> *)block;
+}
+
+template <int N>
+void freeBoard(Board<N> *board) {
+  //give a board back to the free list of the calling thread
+  BoardPool<N>::pools[omp_get_thread_num()].freeBoards.push_back(board);
+}
+
+template <int N>
+void releaseBoards() {
+  //free every board the pools allocated, those still in use included
+  for (int t = 0; t < MAX_THREADS; t++) {
+    BoardPool<N> &pool = BoardPool<N>::pools[t];
+    for (size_t k = 0; k < pool.allBoards.size(); k++) free(pool.allBoards[k]);
+    pool.allBoards.clear();
+    pool.freeBoards.clear();
+  }
+}
+
+template <int N>
+Board<N> *copyBoard(Board<N> *board) {
+  Board<N> *newBoard = poolBoard<N>();
+  memcpy(newBoard, board, sizeof(Board<N>));
+  //the copy starts a search of its own
+  newBoard->trail = NULL;
+  return newBoard;
+}
+
+template <int N>
+void linkCell(Board<N> *board, int i, int count) {
+  //put empty cell i at the front of the list of cells with count choices
+  int next = board->firstCell[count];
+  board->prevCell[i] = -1;
+  board->nextCell[i] = next;
+  if (next >= 0) board->prevCell[next] = i;
+  board->firstCell[count] = i;
+}
+
+template <int N>
+void unlinkCell(Board<N> *board, int i, int count) {
+  //take empty cell i out of the list of cells with count choices
+  int prev = board->prevCell[i];
+  int next = board->nextCell[i];
+  if (prev >= 0) board->nextCell[prev] = next;
+  else board->firstCell[count] = next;
+  if (next >= 0) board->prevCell[next] = prev;
+}
+
+template <int N>
+bool removeChoices(Board<N> *board, int i, typename Board<N>::Mask remove) {
+  typedef typename Board<N>::Mask Mask;
+  const int boardSize = N * N;
+  /* narrow the choices of cell i, taking an empty cell out of the planes of the
+     removed choices. return false iff a removed choice is left with no cell
+     to go to in one of the units of the cell */
+  Mask removed = board->options[i] & remove;
+  if (board->trail && removed) {
+    typename Trail<N>::Change change = {i, 0, removed};
+    board->trail->changes.push_back(change);
+  }
+  if (!board->values[i] && removed) {
+    unlinkCell(board, i, popCount(board->options[i]));
+    linkCell(board, i, popCount(board->options[i] & ~remove));
+  }
+  board->options[i] &= ~remove;
+  const int *units = Topology<N>::table.cellUnits[i];
+  bool empty = !board->values[i];
+  Mask column = ~(Mask(1) << (i % boardSize));
+  int row = i / boardSize;
+  bool feasible = true;
+  while (removed) {
+    int d = lowestBit(removed);
+    if (empty) board->planes[d][row] &= column;
+    for (int u = 0; u < 3; u++) {
+      if (!--board->positions[units[u]][d]) feasible = false;
+    }
+    removed &= ~(Mask(1) << d);
+  }
+  return feasible;
+}
+
+template <int N>
+bool setValue(Board<N> *board, int i, int num) {
+  typedef typename Board<N>::Mask Mask;
+  const int boardSize = N * N;
+  //write the final value of an empty cell, leaving it as its only choice
+  Mask digit = digitMask<Mask>(num);
+  bool feasible = removeChoices(board, i, ~digit);
+  //the cell is no longer empty, so it leaves the plane of its number and the lists too
+  board->planes[num - 1][i / boardSize] &= ~(Mask(1) << (i % boardSize));
+  unlinkCell(board, i, popCount(board->options[i]));
+  const int *units = Topology<N>::table.cellUnits[i];
+  for (int u = 0; u < 3; u++) board->unitEmpty[units[u]]--;
+  board->options[i] = digit;
+  board->values[i] = num;
+  board->emptyCells--;
+  if (board->trail) {
+    typename Trail<N>::Change change = {i, num, Mask(0)};
+    board->trail->changes.push_back(change);
+  }
+  return feasible;
+}
+
+template <int N>
+void undoTrail(Board<N> *board, size_t mark) {
+  //undo the changes logged since the trail had mark entries, latest first
+  typedef typename Board<N>::Mask Mask;
+  const int boardSize = N * N;
+  std::vector<typename Trail<N>::Change> &changes = board->trail->changes;
+  while (changes.size() > mark) {
+    typename Trail<N>::Change change = changes.back();
+    changes.pop_back();
+    int i = change.cell;
+    const int *units = Topology<N>::table.cellUnits[i];
+    Mask bit = Mask(1) << (i % boardSize);
+    int row = i / boardSize;
+    if (change.num) {
+      //the cell is empty again, with its number as only choice
+      board->values[i] = 0;
+      board->emptyCells++;
+      for (int u = 0; u < 3; u++) board->unitEmpty[units[u]]++;
+      board->planes[change.num - 1][row] |= bit;
+      linkCell(board, i, popCount(board->options[i]));
+      continue;
+    }
+    Mask removed = change.removed;
+    bool empty = !board->values[i];
+    if (empty) {
+      unlinkCell(board, i, popCount(board->options[i]));
+      linkCell(board, i, popCount(board->options[i] | removed));
+    }
+    board->options[i] |= removed;
+    while (removed) {
+      int d = lowestBit(removed);
+      if (empty) board->planes[d][row] |= bit;
+      for (int u = 0; u < 3; u++) board->positions[units[u]][d]++;
+      removed &= ~(Mask(1) << d);
+    }
+  }
+}
+
+template <int N>
+int branchCell(Board<N> *board) {
+  /* the empty cell with the fewest choices, ties going to the cell whose units
+     have the fewest empty cells left. -1 iff the board is solved */
+  const int boardSize = N * N;
+  for (int count = 0; count <= boardSize; count++) {
+    int best = -1;
+    int bestEmpty = 0;
+    for (int i = board->firstCell[count]; i >= 0; i = board->nextCell[i]) {
+      const int *units = Topology<N>::table.cellUnits[i];
+      int empty = board->unitEmpty[units[0]] + board->unitEmpty[units[1]] + board->unitEmpty[units[2]];
+      if (best < 0 || empty < bestEmpty) {
+        best = i;
+        bestEmpty = empty;
+      }
+    }
+    if (best >= 0) return best;
+  }
+  return -1;
+}
+
+//order in which the alternatives of a branch are tried
+enum ValueOrder { ORDER_ASCENDING, ORDER_LCV, ORDER_RANDOM };
+static const char *orderNames[] = {"asc", "lcv", "random"};
+static int valueOrder = ORDER_ASCENDING;
+//seed of the random order, a branch is shuffled the same way whichever thread takes it
+static unsigned randomSeed = 0;
+//false branches on the most constrained cell only, never on where a number goes in a unit
+static bool branchOnUnits = true;
+//every thread has its own search configuration, so a portfolio can race several
+#pragma omp threadprivate(valueOrder, randomSeed, branchOnUnits)
+
+inline bool setValueOrder(const char *name) {
+  //return false iff name is not a known order
+  for (int k = 0; k < 3; k++) {
+    if (!strcmp(name, orderNames[k])) {
+      valueOrder = k;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <int N>
+void orderChoices(Board<N> *board, int *cells, int *nums, int numChoices) {
+  /* put the alternatives of a branch in the order of valueOrder: ascending
+     as found, least constraining first (the number is taken from the fewest
+     peers of the cell), or shuffled from randomSeed and the branch */
+  typedef typename Board<N>::Mask Mask;
+  const Topology<N> &topo = Topology<N>::table;
+  if (valueOrder == ORDER_LCV) {
+    int removes[N * N];
+    for (int k = 0; k < numChoices; k++) {
+      Mask digit = digitMask<Mask>(nums[k]);
+      removes[k] = 0;
+      for (int p = 0; p < Topology<N>::numPeers; p++) {
+        if (board->options[topo.peers[cells[k]][p]] & digit) removes[k]++;
+      }
+    }
+    //insertion sort, keeping ties ascending
+    for (int k = 1; k < numChoices; k++) {
+      int cell = cells[k], num = nums[k], r = removes[k];
+      int j = k;
+      for (; j > 0 && removes[j - 1] > r; j--) {
+        cells[j] = cells[j - 1];
+        nums[j] = nums[j - 1];
+        removes[j] = removes[j - 1];
+      }
+      cells[j] = cell;
+      nums[j] = num;
+      removes[j] = r;
+    }
+  } else if (valueOrder == ORDER_RANDOM) {
+    //xorshift, seeded from the branch so that the order doesn't depend on the thread
+    unsigned state = (randomSeed * 2654435761u) ^ (cells[0] * 40503u) ^ board->emptyCells;
+    state = (state ^ (state >> 16)) * 0x85ebca6bu;
+    if (!state) state = 1;
+    for (int k = numChoices - 1; k > 0; k--) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      int j = ((unsigned long long)state * (k + 1)) >> 32;
+      int cell = cells[k], num = nums[k];
+      cells[k] = cells[j];
+      nums[k] = nums[j];
+      cells[j] = cell;
+      nums[j] = num;
+    }
+  }
+}
+
+template <int N>
+int branchUnit(Board<N> *board, int &digit) {
+  /* the unit and number (from 0) with the fewest cells left that can take
+     it, two at least so that units already holding it are skipped. -1 if none */
+  const int boardSize = N * N;
+  int best = -1;
+  int bestCount = boardSize + 1;
+  for (int u = 0; u < 3 * boardSize; u++) {
+    const unsigned char *positions = board->positions[u];
+    for (int d = 0; d < boardSize; d++) {
+      if (positions[d] >= 2 && positions[d] < bestCount) {
+        best = u;
+        digit = d;
+        bestCount = positions[d];
+        if (bestCount == 2) return best;
+      }
+    }
+  }
+  return best;
+}
+
+template <int N>
+int branchChoices(Board<N> *board, int *cells, int *nums) {
+  /* the alternatives to branch on, as cell and number pairs: the choices of
+     the most constrained cell, or the cells where a number can go in a unit
+     when there are fewer of those, in the order of orderChoices(). return
+     how many were written */
+  typedef typename Board<N>::Mask Mask;
+  const int boardSize = N * N;
+  Mask *options = board->options;
+  int i = branchCell(board);
+  int count = popCount(options[i]);
+  int numChoices = 0;
+  int d;
+  int unit = (branchOnUnits && count > 2) ? branchUnit(board, d) : -1;
+  if (unit >= 0 && board->positions[unit][d] < count) {
+    const int *unitCells = Topology<N>::table.unitCells[unit];
+    for (int k = 0; k < boardSize; k++) {
+      int c = unitCells[k];
+      if (!board->values[c] && (options[c] & (Mask(1) << d))) {
+        cells[numChoices] = c;
+        nums[numChoices++] = d + 1;
+      }
+    }
+  } else {
+    for (int choice = 1; choice <= boardSize; choice++) {
+      if (options[i] & digitMask<Mask>(choice)) {
+        cells[numChoices] = i;
+        nums[numChoices++] = choice;
+      }
+    }
+  }
+  orderChoices(board, cells, nums, numChoices);
+  return numChoices;
+}
+
+template <typename Mask>
+std::string cellToString(Mask cell, int boardSize){
+  std::string s = "";
+  for (int i = 1; i <= boardSize; i++){
+    if (cell & digitMask<Mask>(i)){
+      s += std::to_string(i)+"";
+    }
+    else{
+      s += " ";
+    }
+  }
+  return s;
+}
+
+template <int N>
+void printBoard(Board<N> *board) {
+  const int boardSize = N * N;
+  printf("\n\n\n");
+  for (int r = 0; r < boardSize; r++) {
+    if ((r % (int)sqrt(boardSize)) == 0){
+      for (int i = 0; i < boardSize; i++) printf(" ____%d_____ ",r*boardSize +i);
+      printf("\n");
+    }
+    for (int c = 0; c < boardSize; c++)
+    {
+      std::string str = cellToString(board->options[r*boardSize + c],boardSize);
+      printf("%s | ", str.c_str());
+    }
+    printf("\n");
+  }
+}
+
+template <int N>
+void checkUnit(Board<N> *board, int unit, bool &correctness){
+  typedef typename Board<N>::Mask Mask;
+  const int boardSize = N * N;
+  const int *cells = Topology<N>::table.unitCells[unit];
+  unsigned char *values = board->values;
+  //a number is repeated in the unit iff it is seen twice
+  Mask once = 0;
+  Mask twice = 0;
+  for (int i = 0; i < boardSize; i++)
+  {
+    if (values[cells[i]]){
+      Mask digit = digitMask<Mask>(values[cells[i]]);
+      twice = twice | (once & digit);
+      once = once | digit;
+    }
+  }
+  if (twice) correctness = false;
+}
+
+template <int N>
+void checkRows(Board<N> *board, bool &correctness){
+  for (int r = 0; r < N * N; r++) checkUnit(board, r, correctness);
+}
+
+template <int N>
+void checkColumns(Board<N> *board, bool &correctness){
+  for (int c = 0; c < N * N; c++) checkUnit(board, N * N + c, correctness);
+}
+
+template <int N>
+void checkBoxes(Board<N> *board, bool &correctness){
+  for (int b = 0; b < N * N; b++) checkUnit(board, 2 * N * N + b, correctness);
+}
+
+template <int N>
+void compareToOriginal(Board<N> *board, Board<N> *originalBoard, bool &correctness) {
+  const int boardSize = N * N;
+  for (int i = 0; i < boardSize * boardSize; ++i)
+  {
+    if (originalBoard->values[i]) {
+      if (originalBoard->values[i] != board->values[i]) {
+        correctness = false;
+        return;
+      }
+    }
+  }
+}
+
+template <int N>
+void correctnessChecker(Board<N> *board, Board<N> *originalBoard){
+  if (board == NULL) {
+    printf("No Solution\n");
+    return;
+  }
+
+  bool correctness = true;
+  checkRows(board, correctness);
+  checkColumns(board, correctness);
+  checkBoxes(board, correctness);
+
+  compareToOriginal(board, originalBoard, correctness);
+
+  if (correctness){
+    printf("\n\nCorrectness: True\n");
+  }
+  else
+  {
+    printf("\n\nCorrectness: False\n");
+  }
+}
+
+template <int N>
+void addToBoard(int num, int i, Board<N> *board) {
+  typedef typename Board<N>::Mask Mask;
+  const int boardSize = N * N;
+  const int *units = Topology<N>::table.cellUnits[i];
+  if (num) {
+    //num != 0
+    //fixed number on sudoku board, so only 1 choice for the number
+    board->options[i] = digitMask<Mask>(num);
+    for (int u = 0; u < 3; u++) board->positions[units[u]][num - 1]++;
+  } else {
+    //num == 0
+    //blank number on sudoku board, so can be any number
+    board->options[i] = fullMask<Mask>(boardSize);
+    board->emptyCells++;
+    for (int d = 0; d < boardSize; d++) {
+      board->planes[d][i / boardSize] |= Mask(1) << (i % boardSize);
+      for (int u = 0; u < 3; u++) board->positions[units[u]][d]++;
+    }
+    for (int u = 0; u < 3; u++) board->unitEmpty[units[u]]++;
+    linkCell(board, i, boardSize);
+  }
+  board->values[i] = num;
+}
+
+template <int N>
+Board<N> *readBoard(FILE *input) {
+  const int boardSize = N * N;
+  Board<N> *board = allocBoard<N>();
+
+  //for parsing sudoku board
+  int num;
+
+  for (int row = 0; row < boardSize; row++) {
+    for (int col = 0; col < boardSize; col++) {
+      int i = row * boardSize + col;
+      fscanf(input, "%d", &num);
+      addToBoard(num, i, board);
+    }
+    fscanf(input, "\n");
+  }
+  return board;
+}
+
+template <int N>
+void writeFile(FILE *output_file, Board<N> *board, int i) {
+  fprintf(output_file, "%02d ", board->values[i]);
+}
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * Chase-Lev work-stealing deque for the parallel Sudoku solver
+ * Christopher Shan(cshan1), Omar Shafie(oshafie)
+ *
+ * Every thread owns one deque: it pushes and pops boards at the bottom (LIFO,
+ * deepest first) without taking a lock, while idle threads steal the oldest,
+ * shallowest boards from the top. Owner and thieves only meet on a compare
+ * and swap of top when one item is left. Memory orders follow Le et al.,
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+
+#ifndef DEQUE_H
+#define DEQUE_H
+
+#include <atomic>
+#include <vector>
+
+#ifndef CACHE_LINE
+#define CACHE_LINE 64
+#endif
+
+//circular array of items, capacity a power of 2
+template <typename T>
+struct DequeBuffer {
+  long capacity;
+  std::atomic<T> *items;
+};
+
+template <typename T>
+struct alignas(CACHE_LINE) WorkDeque {
+  //oldest item, advanced by thieves and by the owner taking the last item
+  std::atomic<long> top;
+  //one past the newest item, written by the owner only. on its own cache line
+  //so that thieves reading top don't take it from the owner
+  alignas(CACHE_LINE) std::atomic<long> bottom;
+  std::atomic<DequeBuffer<T> *> buffer;
+  //buffers outgrown by the owner, kept until destroyDeque since a thief may still read them
+  std::vector<DequeBuffer<T> *> retired;
+};
+
+template <typename T>
+DequeBuffer<T> *newDequeBuffer(long capacity) {
+  DequeBuffer<T> *buffer = new DequeBuffer<T>;
+  buffer->capacity = capacity;
+  buffer->items = new std::atomic<T>[capacity];
+  return buffer;
+}
+
+template <typename T>
+void initDeque(WorkDeque<T> &deque, long capacity) {
+  deque.top.store(0, std::memory_order_relaxed);
+  deque.bottom.store(0, std::memory_order_relaxed);
+  deque.buffer.store(newDequeBuffer<T>(capacity), std::memory_order_relaxed);
+}
+
+template <typename T>
+void destroyDeque(WorkDeque<T> &deque) {
+  //only once no thread uses the deque any more
+  DequeBuffer<T> *buffer = deque.buffer.load(std::memory_order_relaxed);
+  deque.retired.push_back(buffer);
+  for (size_t k = 0; k < deque.retired.size(); k++) {
+    delete[] deque.retired[k]->items;
+    delete deque.retired[k];
+  }
+  deque.retired.clear();
+  deque.buffer.store(NULL, std::memory_order_relaxed);
+}
+
+template <typename T>
+long dequeSize(WorkDeque<T> &deque) {
+  //items left, only a hint when read by another thread than the owner
+  long size = deque.bottom.load(std::memory_order_relaxed) - deque.top.load(std::memory_order_relaxed);
+  return size > 0 ? size : 0;
+}
+
+template <typename T>
+void dequePush(WorkDeque<T> &deque, T item) {
+  //owner only: add item at the bottom, doubling the buffer when it is full
+  long b = deque.bottom.load(std::memory_order_relaxed);
+  long t = deque.top.load(std::memory_order_acquire);
+  DequeBuffer<T> *buffer = deque.buffer.load(std::memory_order_relaxed);
+  if (b - t > buffer->capacity - 1) {
+    DequeBuffer<T> *bigger = newDequeBuffer<T>(2 * buffer->capacity);
+    for (long k = t; k < b; k++) {
+      bigger->items[k & (bigger->capacity - 1)].store(
+          buffer->items[k & (buffer->capacity - 1)].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    deque.retired.push_back(buffer);
+    deque.buffer.store(bigger, std::memory_order_release);
+    buffer = bigger;
+  }
+  buffer->items[b & (buffer->capacity - 1)].store(item, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  deque.bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+template <typename T>
+T dequePop(WorkDeque<T> &deque) {
+  //owner only: take the newest item, NULL if the deque is empty
+  long b = deque.bottom.load(std::memory_order_relaxed) - 1;
+  DequeBuffer<T> *buffer = deque.buffer.load(std::memory_order_relaxed);
+  deque.bottom.store(b, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  long t = deque.top.load(std::memory_order_relaxed);
+  if (t > b) {
+    //empty
+    deque.bottom.store(b + 1, std::memory_order_relaxed);
+    return NULL;
+  }
+  T item = buffer->items[b & (buffer->capacity - 1)].load(std::memory_order_relaxed);
+  if (t == b) {
+    //last item, race the thieves for it
+    if (!deque.top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      item = NULL;
+    }
+    deque.bottom.store(b + 1, std::memory_order_relaxed);
+  }
+  return item;
+}
+
+template <typename T>
+T dequeSteal(WorkDeque<T> &deque) {
+  //any thread: take the oldest item, NULL if the deque is empty or another thread won it
+  long t = deque.top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  long b = deque.bottom.load(std::memory_order_acquire);
+  if (t >= b) return NULL;
+  DequeBuffer<T> *buffer = deque.buffer.load(std::memory_order_acquire);
+  T item = buffer->items[t & (buffer->capacity - 1)].load(std::memory_order_relaxed);
+  if (!deque.top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+    return NULL;
+  }
+  return item;
+}
+
+#endif
@@ -0,0 +1,157 @@
+/**
+ * Dancing Links (Algorithm X) exact cover engine for the Sudoku solvers
+ * Christopher Shan(cshan1), Omar Shafie(oshafie)
+ *
+ * Every candidate (cell, number) is a row covering four columns: the cell,
+ * the number on its row, the number on its column and the number in its box.
+ * A solution picks one row per column. The column with the fewest rows left
+ * is always branched on first, which the links give for free.
+ */
+
+#ifndef DLX_H
+#define DLX_H
+
+#include <vector>
+
+#include "board.h"
+
+template <int N>
+struct DancingLinks {
+  static const int boardSize = N * N;
+  static const int totalSquares = boardSize * boardSize;
+  static const int numColumns = 4 * totalSquares;
+
+  //node 0 is the root, nodes 1..numColumns the column headers, then the rows
+  std::vector<int> left;
+  std::vector<int> right;
+  std::vector<int> up;
+  std::vector<int> down;
+  //column header of every node
+  std::vector<int> column;
+  //candidate row of every node
+  std::vector<int> rowOf;
+  //rows left in every column
+  std::vector<int> size;
+  //cell and number of every candidate row
+  std::vector<int> rowCell;
+  std::vector<int> rowNum;
+  //rows picked so far
+  std::vector<int> solution;
+};
+
+template <int N>
+void dlxCover(DancingLinks<N> &dlx, int c) {
+  //take column c out of the header list and its rows out of the other columns
+  dlx.right[dlx.left[c]] = dlx.right[c];
+  dlx.left[dlx.right[c]] = dlx.left[c];
+  for (int i = dlx.down[c]; i != c; i = dlx.down[i]) {
+    for (int j = dlx.right[i]; j != i; j = dlx.right[j]) {
+      dlx.down[dlx.up[j]] = dlx.down[j];
+      dlx.up[dlx.down[j]] = dlx.up[j];
+      dlx.size[dlx.column[j]]--;
+    }
+  }
+}
+
+template <int N>
+void dlxUncover(DancingLinks<N> &dlx, int c) {
+  //undo dlxCover(c), in the reverse order
+  for (int i = dlx.up[c]; i != c; i = dlx.up[i]) {
+    for (int j = dlx.left[i]; j != i; j = dlx.left[j]) {
+      dlx.size[dlx.column[j]]++;
+      dlx.down[dlx.up[j]] = j;
+      dlx.up[dlx.down[j]] = j;
+    }
+  }
+  dlx.right[dlx.left[c]] = c;
+  dlx.left[dlx.right[c]] = c;
+}
+
+template <int N>
+void dlxBuild(DancingLinks<N> &dlx, Board<N> *board) {
+  //one row per remaining choice of every cell, so the initial eliminations are kept
+  typedef typename Board<N>::Mask Mask;
+  const int boardSize = N * N;
+  const int totalSquares = boardSize * boardSize;
+  const int numColumns = DancingLinks<N>::numColumns;
+  for (int c = 0; c <= numColumns; c++) {
+    dlx.left.push_back(c == 0 ? numColumns : c - 1);
+    dlx.right.push_back(c == numColumns ? 0 : c + 1);
+    dlx.up.push_back(c);
+    dlx.down.push_back(c);
+    dlx.column.push_back(c);
+    dlx.rowOf.push_back(-1);
+    dlx.size.push_back(0);
+  }
+
+  for (int i = 0; i < totalSquares; i++) {
+    int row = i / boardSize;
+    int col = i % boardSize;
+    int box = (row / N) * N + col / N;
+    for (int d = 0; d < boardSize; d++) {
+      if (!(board->options[i] & (Mask(1) << d))) continue;
+      int candidate = dlx.rowCell.size();
+      dlx.rowCell.push_back(i);
+      dlx.rowNum.push_back(d + 1);
+      int columns[4] = {1 + i,
+                        1 + totalSquares + row * boardSize + d,
+                        1 + 2 * totalSquares + col * boardSize + d,
+                        1 + 3 * totalSquares + box * boardSize + d};
+      int first = dlx.left.size();
+      for (int k = 0; k < 4; k++) {
+        int node = first + k;
+        int c = columns[k];
+        //link into the row, circularly
+        dlx.left.push_back(k == 0 ? first + 3 : node - 1);
+        dlx.right.push_back(k == 3 ? first : node + 1);
+        //append to the bottom of the column
+        dlx.up.push_back(dlx.up[c]);
+        dlx.down.push_back(c);
+        dlx.down[dlx.up[c]] = node;
+        dlx.up[c] = node;
+        dlx.column.push_back(c);
+        dlx.rowOf.push_back(candidate);
+        dlx.size[c]++;
+      }
+    }
+  }
+}
+
+template <int N>
+bool dlxSearch(DancingLinks<N> &dlx) {
+  //return true iff every column got covered, with the picked rows in dlx.solution
+  if (dlx.right[0] == 0) return true;
+
+  //branch on the column with the fewest rows left
+  int best = dlx.right[0];
+  for (int c = dlx.right[best]; c != 0; c = dlx.right[c]) {
+    if (dlx.size[c] < dlx.size[best]) best = c;
+  }
+  if (!dlx.size[best]) return false;
+
+  dlxCover(dlx, best);
+  for (int i = dlx.down[best]; i != best; i = dlx.down[i]) {
+    dlx.solution.push_back(dlx.rowOf[i]);
+    for (int j = dlx.right[i]; j != i; j = dlx.right[j]) dlxCover(dlx, dlx.column[j]);
+    if (dlxSearch(dlx)) return true;
+    for (int j = dlx.left[i]; j != i; j = dlx.left[j]) dlxUncover(dlx, dlx.column[j]);
+    dlx.solution.pop_back();
+  }
+  dlxUncover(dlx, best);
+  return false;
+}
+
+template <int N>
+Board<N> *dlxSolve(Board<N> *board) {
+  //fill in board and return it if it has a solution, NULL otherwise
+  DancingLinks<N> dlx;
+  dlxBuild(dlx, board);
+  if (!dlxSearch(dlx)) return NULL;
+  for (size_t k = 0; k < dlx.solution.size(); k++) {
+    int i = dlx.rowCell[dlx.solution[k]];
+    if (!board->values[i]) setValue(board, i, dlx.rowNum[dlx.solution[k]]);
+  }
+  return board;
+}
+
+#endif
@@ -0,0 +1,681 @@
+/**
+ * Humanistic (constraint propagation) strategies shared by the OpenMP solvers
+ * Christopher Shan(cshan1), Omar Shafie(oshafie)
+ */
+
+#ifndef HUMANISTIC_H
+#define HUMANISTIC_H
+
+#include <atomic>
+#include <chrono>
+
+#include "board.h"
+#include "simd.h"
+#include "topology.h"
+
+//largest naked/hidden subset looked for, 1 turns subsets off
+static int maxSubsetSize = 3;
+//largest fish looked for (2 X-Wing, 3 Swordfish, 4 Jellyfish), 1 turns fish
+//off and -1 picks the size by board size in fishSize()
+static int maxFishSize = -1;
+#pragma omp threadprivate(maxSubsetSize, maxFishSize)
+
+/* set by the solver once the search is over, e.g. when a solution was found,
+   so that threads still propagating other boards give up at the next step */
+static std::atomic<bool> *cancelToken = NULL;
+
+inline bool cancelled() {
+  return cancelToken && cancelToken->load(std::memory_order_relaxed);
+}
+
+/* cells and units that changed since the strategies last looked at them, so
+   that propagation only re-examines the part of the board a move touched */
+template <int N>
+struct Worklist {
+  static const int totalSquares = N * N * N * N;
+  static const int numUnits = 3 * N * N;
+  //one dirty bit per strategy that examines whole units
+  static const unsigned char LONE_RANGER = 1;
+  static const unsigned char BOX_LINE = 2;
+  static const unsigned char SUBSETS = 4;
+  static const unsigned char FISH = 8;
+  static const unsigned char ALL = 15;
+
+  //empty cells whose choices changed since elimination last checked them
+  int cells[totalSquares];
+  int numCells;
+  bool queued[totalSquares];
+  //strategies that have not examined each unit since it last changed
+  unsigned char dirty[numUnits];
+  //set as soon as a cell has no choice left or a number no cell of some unit
+  bool infeasible;
+};
+
+template <int N>
+void initWorklist(Worklist<N> &work) {
+  work.numCells = 0;
+  memset(work.queued, 0, sizeof(work.queued));
+  memset(work.dirty, 0, sizeof(work.dirty));
+  work.infeasible = false;
+}
+
+template <int N>
+void markChanged(Worklist<N> &work, int i) {
+  //queue the cell for elimination and make every strategy revisit its units
+  if (!work.queued[i]) {
+    work.queued[i] = true;
+    work.cells[work.numCells++] = i;
+  }
+  const int *units = Topology<N>::table.cellUnits[i];
+  for (int u = 0; u < 3; u++) work.dirty[units[u]] = Worklist<N>::ALL;
+}
+
+template <int N>
+void removeChoices(Board<N> *board, int i, typename Board<N>::Mask remove, Worklist<N> &work) {
+  //narrow the choices of cell i, queueing it if anything was removed
+  if (board->options[i] & remove) {
+    if (!removeChoices(board, i, remove) || !board->options[i]) work.infeasible = true;
+    markChanged(work, i);
+  }
+}
+
+template <int N>
+void eliminateChoices(Board<N> *board, int i) {
+  typedef typename Board<N>::Mask Mask;
+  const Topology<N> &topo = Topology<N>::table;
+  Mask *options = board->options;
+  //remove the number of the cell as option from its peers
+  Mask digit = digitMask<Mask>(board->values[i]);
+  for (int p = 0; p < Topology<N>::numPeers; p++) {
+    int A = topo.peers[i][p];
+    if (options[A] & digit) removeChoices(board, A, digit);
+  }
+}
+
+template <int N>
+void eliminateChoices(Board<N> *board, int i, Worklist<N> &work) {
+  //same as above, queueing the peers that actually lost the number
+  typedef typename Board<N>::Mask Mask;
+  const Topology<N> &topo = Topology<N>::table;
+  Mask *options = board->options;
+  Mask digit = digitMask<Mask>(board->values[i]);
+  for (int p = 0; p < Topology<N>::numPeers; p++) {
+    int A = topo.peers[i][p];
+    if (options[A] & digit) removeChoices(board, A, digit, work);
+  }
+}
+
+template <int N>
+void assignCell(Board<N> *board, int i, int num, Worklist<N> &work) {
+  if (!setValue(board, i, num)) work.infeasible = true;
+  markChanged(work, i);
+  eliminateChoices(board, i, work);
+}
+
+template <int N>
+bool elimination(Board<N> *board, Worklist<N> &work, bool &cellChanged) {
+  //return false iff the board given has no valid solution
+  typedef typename Board<N>::Mask Mask;
+  Mask *options = board->options;
+  unsigned char *values = board->values;
+  //only cells whose choices changed can have become single or empty
+  while (work.numCells) {
+    if (work.infeasible) return false;
+    int i = work.cells[--work.numCells];
+    work.queued[i] = false;
+    if (!values[i]) {
+      //cell is currently empty
+      Mask choices = options[i];
+      //all the choice bits are 0, so no solution to board
+      if (!choices) return false;
+
+      if (isSingle(choices)) {
+        //there is only one value this cell can take
+        cellChanged = true;
+        assignCell(board, i, maskToDigit(choices), work);
+      }
+    }
+  }
+  return !work.infeasible;
+}
+
+template <int N>
+bool setLoneRanger(Board<N> *board, int i, typename Board<N>::Mask choices, Worklist<N> &work) {
+  //if choices still has 1 choice write it to the cell and eliminate it from relevant cells
+  if (!isSingle(choices)) return false;
+  assignCell(board, i, maskToDigit(choices), work);
+  return true;
+}
+
+template <int N>
+bool loneRanger(Board<N> *board, Worklist<N> &work, bool &cellChanged) {
+  //return false iff some unit has a number that no cell of it can take, or a cell that two numbers need
+  typedef typename Board<N>::Mask Mask;
+  const int boardSize = N * N;
+  const Topology<N> &topo = Topology<N>::table;
+  const Mask all = fullMask<Mask>(boardSize);
+  Mask *options = board->options;
+  unsigned char *values = board->values;
+  for (int u = 0; u < Topology<N>::numUnits; u++) {
+    if (!(work.dirty[u] & Worklist<N>::LONE_RANGER)) continue;
+    work.dirty[u] &= ~Worklist<N>::LONE_RANGER;
+    const int *cells = topo.unitCells[u];
+
+    //choices seen in at least one and in at least two cells of the unit
+    Mask once;
+    Mask twice;
+    if (u < boardSize) onceTwice(options, (const int *)NULL, u * boardSize, 1, boardSize, once, twice);
+    else if (u < 2 * boardSize) onceTwice(options, (const int *)NULL, u - boardSize, boardSize, boardSize, once, twice);
+    else onceTwice(options, cells, 0, 0, boardSize, once, twice);
+    if (once != all) return false;
+
+    //choices that only one cell of the unit can take
+    Mask lone = once & ~twice;
+    if (!lone) continue;
+    for (int c = 0; c < boardSize; c++) {
+      int i = cells[c];
+      if (!values[i]) {
+        //cell is currently empty, it is a lone ranger if it holds one of those choices
+        Mask mine = options[i] & lone;
+        if (!mine) continue;
+        //the only cell of the unit for two numbers can't take both
+        if (!isSingle(mine)) return false;
+        if (setLoneRanger(board, i, mine, work)) cellChanged = true;
+        if (work.infeasible) return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <int N>
+void removeFromPlane(Board<N> *board, int d, int row, typename Board<N>::Mask columns, Worklist<N> &work, bool &choicesChanged){
+  //remove the number d+1 from the cells on the given columns of row
+  typedef typename Board<N>::Mask Mask;
+  const int boardSize = N * N;
+  Mask found = board->planes[d][row] & columns;
+  if (found) choicesChanged = true;
+  while (found) {
+    int c = lowestBit(found);
+    removeChoices(board, row * boardSize + c, Mask(1) << d, work);
+    found &= ~(Mask(1) << c);
+  }
+}
+
+template <int N>
+bool boxElimination(Board<N> *board, Worklist<N> &work, bool &choicesChanged){
+  /* locked candidates, worked out on the digit planes.
+     pointing: if a box can only take a number on one of its rows (columns),
+     no other cell of that row (column) can take it.
+     claiming: if a row (column) can only take a number inside one box, no
+     other cell of that box can take it */
+  typedef typename Board<N>::Mask Mask;
+  const int boardSize = N * N;
+  //columns of each band of N boxes
+  Mask bands[N];
+  for (int k = 0; k < N; k++) bands[k] = fullMask<Mask>(N) << (k * N);
+
+  for (int box = 0; box < boardSize; box++)
+  {
+    int unit = 2 * boardSize + box;
+    if (!(work.dirty[unit] & Worklist<N>::BOX_LINE)) continue;
+    work.dirty[unit] &= ~Worklist<N>::BOX_LINE;
+    int firstRow = (box / N) * N;
+    Mask band = bands[box % N];
+    for (int d = 0; d < boardSize; d++){
+      Mask *plane = board->planes[d];
+      int rowsWith = 0;
+      int onlyRow = 0;
+      Mask columns = 0;
+      for (int k = 0; k < N; k++){
+        Mask inBox = plane[firstRow + k] & band;
+        if (inBox){
+          rowsWith++;
+          onlyRow = firstRow + k;
+          columns |= inBox;
+        }
+      }
+      if (rowsWith == 1){
+        removeFromPlane(board, d, onlyRow, ~band, work, choicesChanged);
+      }
+      if (isSingle(columns)){
+        for (int r = 0; r < boardSize; r++){
+          if (r < firstRow || r >= firstRow + N) removeFromPlane(board, d, r, columns, work, choicesChanged);
+        }
+      }
+    }
+  }
+
+  for (int row = 0; row < boardSize; row++)
+  {
+    if (!(work.dirty[row] & Worklist<N>::BOX_LINE)) continue;
+    work.dirty[row] &= ~Worklist<N>::BOX_LINE;
+    int firstRow = (row / N) * N;
+    for (int d = 0; d < boardSize; d++){
+      Mask *plane = board->planes[d];
+      if (!plane[row]) continue;
+      Mask band = bands[lowestBit(plane[row]) / N];
+      if (plane[row] & ~band) continue;
+      //the row can only take d+1 inside one box
+      for (int k = 0; k < N; k++){
+        if (firstRow + k != row) removeFromPlane(board, d, firstRow + k, band, work, choicesChanged);
+      }
+    }
+  }
+
+  //columns that changed since the last pass
+  Mask dirtyColumns = 0;
+  for (int col = 0; col < boardSize; col++)
+  {
+    int unit = boardSize + col;
+    if (!(work.dirty[unit] & Worklist<N>::BOX_LINE)) continue;
+    work.dirty[unit] &= ~Worklist<N>::BOX_LINE;
+    dirtyColumns |= Mask(1) << col;
+  }
+  if (!dirtyColumns) return true;
+  for (int d = 0; d < boardSize; d++){
+    Mask *plane = board->planes[d];
+    //columns that can take d+1 in each band of N rows, and in at least two of them
+    Mask bandColumns[N];
+    Mask once = 0;
+    Mask twice = 0;
+    for (int k = 0; k < N; k++){
+      bandColumns[k] = 0;
+      for (int r = k * N; r < (k + 1) * N; r++) bandColumns[k] |= plane[r];
+      twice |= once & bandColumns[k];
+      once |= bandColumns[k];
+    }
+    Mask confined = once & ~twice & dirtyColumns;
+    while (confined){
+      //the column can only take d+1 inside one box
+      int col = lowestBit(confined);
+      Mask bit = Mask(1) << col;
+      confined &= ~bit;
+      int k = 0;
+      while (!(bandColumns[k] & bit)) k++;
+      for (int r = k * N; r < (k + 1) * N; r++){
+        removeFromPlane(board, d, r, bands[col / N] & ~bit, work, choicesChanged);
+      }
+    }
+  }
+  return true;
+}
+
+template <typename Mask>
+bool searchSubsets(const Mask *items, int count, int from, int depth, int maxSize, Mask chosen, Mask covered,
+                   Mask *foundItems, Mask *foundBits, int &numFound) {
+  /* extend the chosen items with items[from..count) looking for combinations of
+     s items covering exactly s bits, recorded in foundItems/foundBits.
+     items that are 0 are skipped. return false iff s items cover fewer than s bits */
+  for (int x = from; x < count; x++) {
+    if (!items[x]) continue;
+    Mask bits = covered | items[x];
+    int size = popCount(bits);
+    if (size > maxSize) continue; //can't be closed within maxSize items
+    Mask picked = chosen | (Mask(1) << x);
+    if (size < depth + 1) return false;
+    if (size == depth + 1) {
+      if (numFound < (int)(8 * sizeof(Mask))) {
+        foundItems[numFound] = picked;
+        foundBits[numFound] = bits;
+        numFound++;
+      }
+      continue;
+    }
+    if (!searchSubsets(items, count, x + 1, depth + 1, maxSize, picked, bits, foundItems, foundBits, numFound)) return false;
+  }
+  return true;
+}
+
+template <int N>
+bool subsetsInUnit(Board<N> *board, Worklist<N> &work, int unit, bool &choicesChanged){
+  /* naked subsets: s empty cells sharing only s choices, which no other cell
+     of the unit can take. hidden subsets: s choices that only s cells of the
+     unit can take, so those cells can't take anything else.
+     return false iff the unit has no valid solution */
+  typedef typename Board<N>::Mask Mask;
+  const int boardSize = N * N;
+  const int bits = 8 * sizeof(Mask);
+  const int *cells = Topology<N>::table.unitCells[unit];
+  Mask *options = board->options;
+  unsigned char *values = board->values;
+
+  //choices of every empty cell and cells of every choice, by position in the unit
+  Mask cellChoices[bits];
+  Mask choiceCells[bits];
+  Mask emptyCells = 0;
+  for (int x = 0; x < boardSize; x++) cellChoices[x] = choiceCells[x] = 0;
+  for (int p = 0; p < boardSize; p++) {
+    if (!values[cells[p]]) {
+      Mask choices = options[cells[p]];
+      emptyCells |= Mask(1) << p;
+      cellChoices[p] = choices;
+      for (Mask rest = choices; rest; ) {
+        int d = lowestBit(rest);
+        choiceCells[d] |= Mask(1) << p;
+        rest &= ~(Mask(1) << d);
+      }
+    }
+  }
+  //subsets with a single member are lone rangers and naked singles, handled elsewhere
+  for (int x = 0; x < boardSize; x++) {
+    int size = popCount(cellChoices[x]);
+    if (size < 2 || size > maxSubsetSize) cellChoices[x] = 0;
+    size = popCount(choiceCells[x]);
+    if (size < 2 || size > maxSubsetSize) choiceCells[x] = 0;
+  }
+
+  Mask foundItems[bits];
+  Mask foundBits[bits];
+  int numFound = 0;
+  if (!searchSubsets(cellChoices, boardSize, 0, 0, maxSubsetSize, Mask(0), Mask(0), foundItems, foundBits, numFound)) return false;
+  for (int f = 0; f < numFound; f++) {
+    //remove the choices of a naked subset from the rest of the unit
+    Mask others = emptyCells & ~foundItems[f];
+    for (int p = 0; p < boardSize; p++) {
+      if ((others & (Mask(1) << p)) && (options[cells[p]] & foundBits[f])) {
+        removeChoices(board, cells[p], foundBits[f], work);
+        choicesChanged = true;
+      }
+    }
+  }
+
+  numFound = 0;
+  if (!searchSubsets(choiceCells, boardSize, 0, 0, maxSubsetSize, Mask(0), Mask(0), foundItems, foundBits, numFound)) return false;
+  for (int f = 0; f < numFound; f++) {
+    //cells of a hidden subset can only take the choices of the subset
+    for (int p = 0; p < boardSize; p++) {
+      if ((foundBits[f] & (Mask(1) << p)) && (options[cells[p]] & ~foundItems[f])) {
+        removeChoices(board, cells[p], ~foundItems[f], work);
+        choicesChanged = true;
+      }
+    }
+  }
+  return true;
+}
+
+template <int N>
+bool subsets(Board<N> *board, Worklist<N> &work, bool &choicesChanged) {
+  //return false iff some unit has no valid solution
+  const int boardSize = N * N;
+  if (maxSubsetSize < 2) return true;
+  //rows, then boxes, then columns
+  const int order[3] = {Topology<N>::ROW, Topology<N>::BOX, Topology<N>::COL};
+  for (int t = 0; t < 3; t++) {
+    for (int k = 0; k < boardSize; k++) {
+      int unit = order[t] * boardSize + k;
+      if (!(work.dirty[unit] & Worklist<N>::SUBSETS)) continue;
+      work.dirty[unit] &= ~Worklist<N>::SUBSETS;
+      if (!subsetsInUnit(board, work, unit, choicesChanged)) return false;
+    }
+  }
+  return true;
+}
+
+template <int N>
+int fishSize() {
+  if (maxFishSize >= 0) return maxFishSize;
+  /* X-Wings still save a few branches on 9x9 boards, larger fish and
+     fish on larger boards cost more than they save on our inputs */
+  if (N <= 3) return 2;
+  return 1;
+}
+
+template <int N>
+bool fishForDigit(Board<N> *board, Worklist<N> &work, int d, int size, bool &choicesChanged) {
+  /* s rows that can only take d+1 on the same s columns: one of those rows
+     takes it on each of the columns, so no other row can take it there.
+     the same holds with rows and columns swapped.
+     return false iff d+1 can't be placed on every row and column */
+  typedef typename Board<N>::Mask Mask;
+  const int boardSize = N * N;
+  Mask *plane = board->planes[d];
+  Mask lines[boardSize];
+  Mask foundItems[8 * sizeof(Mask)];
+  Mask foundBits[8 * sizeof(Mask)];
+  int numFound = 0;
+
+  //base rows, cover columns
+  for (int r = 0; r < boardSize; r++) {
+    int count = popCount(plane[r]);
+    lines[r] = (count >= 2 && count <= size) ? plane[r] : Mask(0);
+  }
+  if (!searchSubsets(lines, boardSize, 0, 0, size, Mask(0), Mask(0), foundItems, foundBits, numFound)) return false;
+  for (int f = 0; f < numFound; f++) {
+    for (int r = 0; r < boardSize; r++) {
+      if (!(foundItems[f] & (Mask(1) << r))) removeFromPlane(board, d, r, foundBits[f], work, choicesChanged);
+    }
+  }
+
+  //base columns, cover rows
+  for (int c = 0; c < boardSize; c++) lines[c] = 0;
+  for (int r = 0; r < boardSize; r++) {
+    for (Mask rest = plane[r]; rest; ) {
+      int c = lowestBit(rest);
+      lines[c] |= Mask(1) << r;
+      rest &= ~(Mask(1) << c);
+    }
+  }
+  for (int c = 0; c < boardSize; c++) {
+    int count = popCount(lines[c]);
+    if (count < 2 || count > size) lines[c] = 0;
+  }
+  numFound = 0;
+  if (!searchSubsets(lines, boardSize, 0, 0, size, Mask(0), Mask(0), foundItems, foundBits, numFound)) return false;
+  for (int f = 0; f < numFound; f++) {
+    for (int r = 0; r < boardSize; r++) {
+      if (foundBits[f] & (Mask(1) << r)) removeFromPlane(board, d, r, ~foundItems[f], work, choicesChanged);
+    }
+  }
+  return true;
+}
+
+template <int N>
+bool fish(Board<N> *board, Worklist<N> &work, bool &choicesChanged) {
+  //return false iff the board has no valid solution
+  int size = fishSize<N>();
+  if (size < 2) return true;
+  //a fish spans the whole board, so any unit that changed makes every digit worth a look
+  bool dirty = false;
+  for (int u = 0; u < Topology<N>::numUnits; u++) {
+    if (work.dirty[u] & Worklist<N>::FISH) dirty = true;
+    work.dirty[u] &= ~Worklist<N>::FISH;
+  }
+  if (!dirty) return true;
+  for (int d = 0; d < N * N; d++) {
+    if (!fishForDigit(board, work, d, size, choicesChanged)) return false;
+  }
+  return true;
+}
+
+/* strategies that run once elimination and lone ranger have nothing left
+   to do, in the order of the pipeline. Each keeps counters so that the ones
+   that rarely remove anything for the time they take can be demoted */
+enum StrategyId { BOX_LINE_STRATEGY, SUBSETS_STRATEGY, FISH_STRATEGY, NUM_STRATEGIES };
+
+struct StrategyStats {
+  //runs of the strategy
+  long invocations;
+  //runs that removed a choice or found a contradiction
+  long successes;
+  //time spent in the strategy
+  long nanoseconds;
+  //runs skipped while the strategy was demoted
+  long skipped;
+  //turns of the strategy while it was demoted, run or skipped
+  long demotedTurns;
+};
+
+static const char *strategyNames[NUM_STRATEGIES] = {"box/line", "subsets", "fish"};
+
+/* counters of every thread, on their own cache lines. demotion only looks at
+   the thread's own, so threads neither race on them nor demote strategies
+   for each other */
+struct alignas(CACHE_LINE) ThreadStrategyStats {
+  StrategyStats strategies[NUM_STRATEGIES];
+};
+
+static ThreadStrategyStats strategyStats[MAX_THREADS];
+
+static int pipeline[NUM_STRATEGIES] = {BOX_LINE_STRATEGY, SUBSETS_STRATEGY, FISH_STRATEGY};
+static int pipelineLength = NUM_STRATEGIES;
+
+/* a strategy is demoted once it has run DEMOTE_AFTER times with fewer than
+   demoteBelow successes per microsecond. A demoted strategy only runs once
+   every DEMOTED_PERIOD turns, so it is promoted again if it starts paying off.
+   demoteBelow = 0 never demotes */
+#define DEMOTE_AFTER 64
+#define DEMOTED_PERIOD 16
+static double demoteBelow = 0.01;
+
+//per thread like the value order, parallel regions start from the master's with copyin(SEARCH_CONFIG)
+#pragma omp threadprivate(pipeline, pipelineLength, demoteBelow)
+#define SEARCH_CONFIG valueOrder, randomSeed, branchOnUnits, \
+  maxSubsetSize, maxFishSize, pipeline, pipelineLength, demoteBelow
+
+inline bool setPreset(const char *preset) {
+  //return false iff preset is not a known preset name
+  if (!strcmp(preset, "cheap")) {
+    //locked candidates only
+    pipeline[0] = BOX_LINE_STRATEGY;
+    pipelineLength = 1;
+    demoteBelow = 0;
+  } else if (!strcmp(preset, "balanced")) {
+    //everything at its default size, dropping what doesn't pay off
+    pipeline[0] = BOX_LINE_STRATEGY;
+    pipeline[1] = SUBSETS_STRATEGY;
+    pipeline[2] = FISH_STRATEGY;
+    pipelineLength = 3;
+    demoteBelow = 0.01;
+  } else if (!strcmp(preset, "full")) {
+    //everything up to quads and jellyfish, always
+    pipeline[0] = BOX_LINE_STRATEGY;
+    pipeline[1] = SUBSETS_STRATEGY;
+    pipeline[2] = FISH_STRATEGY;
+    pipelineLength = 3;
+    maxSubsetSize = 4;
+    maxFishSize = 4;
+    demoteBelow = 0;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+inline bool strategyDemoted(StrategyStats &stats) {
+  if (demoteBelow <= 0 || stats.invocations < DEMOTE_AFTER) return false;
+  double microseconds = stats.nanoseconds / 1000.0 + 1;
+  return stats.successes / microseconds < demoteBelow;
+}
+
+inline void printStrategyStats() {
+  //counters summed over the threads, once they are done
+  printf("Strategy         runs  successes  time(ms)  skipped\n");
+  for (int s = 0; s < NUM_STRATEGIES; s++) {
+    StrategyStats total = {0, 0, 0, 0, 0};
+    for (int t = 0; t < MAX_THREADS; t++) {
+      StrategyStats &stats = strategyStats[t].strategies[s];
+      total.invocations += stats.invocations;
+      total.successes += stats.successes;
+      total.nanoseconds += stats.nanoseconds;
+      total.skipped += stats.skipped;
+    }
+    printf("%-12s %8ld %10ld %9.3lf %8ld\n", strategyNames[s], total.invocations, total.successes,
+           total.nanoseconds / 1e6, total.skipped);
+  }
+}
+
+template <int N>
+bool runStrategy(Board<N> *board, Worklist<N> &work, int id, bool &choicesChanged) {
+  //return false iff the strategy found the board has no valid solution
+  using namespace std::chrono;
+  typedef high_resolution_clock Clock;
+  StrategyStats &stats = strategyStats[omp_get_thread_num()].strategies[id];
+  if (strategyDemoted(stats) && ++stats.demotedTurns % DEMOTED_PERIOD) {
+    stats.skipped++;
+    return true;
+  }
+
+  auto start = Clock::now();
+  bool changed = false;
+  bool solvable = true;
+  switch (id) {
+    case BOX_LINE_STRATEGY: solvable = boxElimination(board, work, changed); break;
+    case SUBSETS_STRATEGY: solvable = subsets(board, work, changed); break;
+    case FISH_STRATEGY: solvable = fish(board, work, changed); break;
+  }
+  long elapsed = duration_cast<nanoseconds>(Clock::now() - start).count();
+
+  stats.invocations++;
+  stats.nanoseconds += elapsed;
+  if (changed || !solvable) stats.successes++;
+  if (changed) choicesChanged = true;
+  return solvable;
+}
+
+template <int N>
+bool propagate(Board<N> *board, Worklist<N> &work) {
+  /* return false if board has no solution or the search was cancelled
+     otherwise (i.e. if solution found or algorithm makes no more changes) return true */
+
+  //in some step of algorithm, a cell was written to with its final value
+  bool cellChanged = true;
+  //in some step of algorithm, choices were eliminated from some cell
+  bool choicesChanged = true;
+  while (cellChanged || choicesChanged) {
+    if (cancelled()) return false;
+    cellChanged = false;
+    choicesChanged = false;
+    if (!elimination(board, work, cellChanged)) return false;
+    if (!loneRanger(board, work, cellChanged)) return false;
+    if (cellChanged) continue;
+    //go back to the cheap steps as soon as a strategy removes something
+    for (int s = 0; s < pipelineLength && !choicesChanged; s++) {
+      if (cancelled()) return false;
+      if (!runStrategy(board, work, pipeline[s], choicesChanged) || work.infeasible) return false;
+    }
+  }
+  return true;
+}
+
+template <int N>
+bool humanistic(Board<N> *board) {
+  /* nothing is known about the board yet, so every unit is examined, but
+     elimination only needs the cells already down to one choice or none */
+  Worklist<N> work;
+  initWorklist(work);
+  //a number with no cell left in some unit, e.g. after clashing givens
+  const unsigned char *positions = &board->positions[0][0];
+  for (int k = 0; k < Topology<N>::numUnits * Board<N>::boardSize; k++) {
+    if (!positions[k]) return false;
+  }
+  memset(work.dirty, Worklist<N>::ALL, sizeof(work.dirty));
+  work.numCells = findSingles(board->options, board->values, Board<N>::totalSquares, work.cells);
+  for (int k = 0; k < work.numCells; k++) work.queued[work.cells[k]] = true;
+  return propagate(board, work);
+}
+
+template <int N>
+bool humanistic(Board<N> *board, int i) {
+  /* board was at a fixpoint before the caller set cell i, so only what
+     follows from that cell has to be examined. the caller checks what
+     setValue returned for the cell itself */
+  Worklist<N> work;
+  initWorklist(work);
+  markChanged(work, i);
+  eliminateChoices(board, i, work);
+  return propagate(board, work);
+}
+
+template <int N>
+void initialChoiceElm(Board<N> *board) {
+  unsigned char *values = board->values;
+  for (int i = 0; i < Board<N>::totalSquares; i++) {
+    if (values[i]) {
+      //if the cell in the board has a value
+      eliminateChoices(board, i);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,317 @@
+/**
+ * SIMD kernels for the unit reductions of the Sudoku solvers
+ * Christopher Shan(cshan1), Omar Shafie(oshafie)
+ *
+ * The AVX2 and AVX-512 kernels are compiled with target attributes and picked
+ * at runtime from what the CPU supports, so the same binary runs on machines
+ * with or without them. 32 and 64 bit masks (boards up to 64x64) have vector
+ * kernels, wider masks and the Xeon Phi build always take the scalar loops.
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstring>
+#include <stdint.h>
+
+#include "bitmask.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(RUN_MIC)
+#define HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+enum SimdLevel { SIMD_SCALAR, SIMD_AVX2, SIMD_AVX512 };
+static const char *simdNames[] = {"scalar", "avx2", "avx512"};
+//kernels used by the solver, set once before solving
+static int simdLevel = SIMD_SCALAR;
+
+inline int detectSimd() {
+#ifdef HAVE_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+  if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+#endif
+  return SIMD_SCALAR;
+}
+
+inline bool setSimd(const char *name) {
+  //return false iff name is not auto or a known level. levels the CPU lacks fall back to the best it has
+  int best = detectSimd();
+  if (!strcmp(name, "auto")) {
+    simdLevel = best;
+    return true;
+  }
+  for (int level = SIMD_SCALAR; level <= SIMD_AVX512; level++) {
+    if (!strcmp(name, simdNames[level])) {
+      simdLevel = level < best ? level : best;
+      return true;
+    }
+  }
+  return false;
+}
+
+/* the cells of a unit: cells[k] if cells is not NULL, otherwise start + k * stride.
+   rows are contiguous, columns strided and boxes gathered through their cell list */
+template <typename Mask>
+void onceTwiceScalar(const Mask *options, const int *cells, int start, int stride, int from, int count,
+                     Mask &once, Mask &twice) {
+  for (int k = from; k < count; k++) {
+    Mask choices = options[cells ? cells[k] : start + k * stride];
+    twice = twice | (once & choices);
+    once = once | choices;
+  }
+}
+
+template <typename Mask>
+void mergeLanes(const Mask *laneOnce, const Mask *laneTwice, int lanes, Mask &once, Mask &twice) {
+  for (int l = 0; l < lanes; l++) {
+    twice = twice | laneTwice[l] | (once & laneOnce[l]);
+    once = once | laneOnce[l];
+  }
+}
+
+template <typename Mask>
+int findSinglesScalar(const Mask *options, const unsigned char *values, int from, int count, int *out) {
+  int found = 0;
+  for (int i = from; i < count; i++) {
+    Mask choices = options[i];
+    if (!values[i] && !(choices & (choices - Mask(1)))) out[found++] = i;
+  }
+  return found;
+}
+
+#ifdef HAVE_X86_SIMD
+
+__attribute__((target("avx2")))
+inline void onceTwiceAvx2(const uint32_t *options, const int *cells, int start, int stride, int count,
+                          uint32_t &once, uint32_t &twice) {
+  __m256i vOnce = _mm256_setzero_si256();
+  __m256i vTwice = _mm256_setzero_si256();
+  __m256i index = _mm256_add_epi32(_mm256_set1_epi32(start),
+                                   _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride)));
+  __m256i step = _mm256_set1_epi32(8 * stride);
+  int k = 0;
+  for (; k + 8 <= count; k += 8) {
+    __m256i x;
+    if (cells) x = _mm256_i32gather_epi32((const int *)options, _mm256_loadu_si256((const __m256i *)(cells + k)), 4);
+    else if (stride == 1) x = _mm256_loadu_si256((const __m256i *)(options + start + k));
+    else {
+      x = _mm256_i32gather_epi32((const int *)options, index, 4);
+      index = _mm256_add_epi32(index, step);
+    }
+    vTwice = _mm256_or_si256(vTwice, _mm256_and_si256(vOnce, x));
+    vOnce = _mm256_or_si256(vOnce, x);
+  }
+  uint32_t laneOnce[8], laneTwice[8];
+  _mm256_storeu_si256((__m256i *)laneOnce, vOnce);
+  _mm256_storeu_si256((__m256i *)laneTwice, vTwice);
+  mergeLanes(laneOnce, laneTwice, 8, once, twice);
+  onceTwiceScalar(options, cells, start, stride, k, count, once, twice);
+}
+
+__attribute__((target("avx2")))
+inline void onceTwiceAvx2(const uint64_t *options, const int *cells, int start, int stride, int count,
+                          uint64_t &once, uint64_t &twice) {
+  __m256i vOnce = _mm256_setzero_si256();
+  __m256i vTwice = _mm256_setzero_si256();
+  __m128i index = _mm_add_epi32(_mm_set1_epi32(start),
+                                _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(stride)));
+  __m128i step = _mm_set1_epi32(4 * stride);
+  int k = 0;
+  for (; k + 4 <= count; k += 4) {
+    __m256i x;
+    if (cells) x = _mm256_i32gather_epi64((const long long *)options, _mm_loadu_si128((const __m128i *)(cells + k)), 8);
+    else if (stride == 1) x = _mm256_loadu_si256((const __m256i *)(options + start + k));
+    else {
+      x = _mm256_i32gather_epi64((const long long *)options, index, 8);
+      index = _mm_add_epi32(index, step);
+    }
+    vTwice = _mm256_or_si256(vTwice, _mm256_and_si256(vOnce, x));
+    vOnce = _mm256_or_si256(vOnce, x);
+  }
+  uint64_t laneOnce[4], laneTwice[4];
+  _mm256_storeu_si256((__m256i *)laneOnce, vOnce);
+  _mm256_storeu_si256((__m256i *)laneTwice, vTwice);
+  mergeLanes(laneOnce, laneTwice, 4, once, twice);
+  onceTwiceScalar(options, cells, start, stride, k, count, once, twice);
+}
+
+/* 512 bit kernels only for contiguous rows: 512 bit gathers came out slower
+   than the 256 bit ones on our machines, so columns and boxes stay on AVX2 */
+__attribute__((target("avx512f")))
+inline void onceTwiceAvx512(const uint32_t *options, int count, uint32_t &once, uint32_t &twice) {
+  __m512i vOnce = _mm512_setzero_si512();
+  __m512i vTwice = _mm512_setzero_si512();
+  int k = 0;
+  for (; k + 16 <= count; k += 16) {
+    __m512i x = _mm512_loadu_si512(options + k);
+    vTwice = _mm512_or_si512(vTwice, _mm512_and_si512(vOnce, x));
+    vOnce = _mm512_or_si512(vOnce, x);
+  }
+  uint32_t laneOnce[16], laneTwice[16];
+  _mm512_storeu_si512(laneOnce, vOnce);
+  _mm512_storeu_si512(laneTwice, vTwice);
+  mergeLanes(laneOnce, laneTwice, 16, once, twice);
+  onceTwiceScalar(options, (const int *)NULL, 0, 1, k, count, once, twice);
+}
+
+__attribute__((target("avx512f")))
+inline void onceTwiceAvx512(const uint64_t *options, int count, uint64_t &once, uint64_t &twice) {
+  __m512i vOnce = _mm512_setzero_si512();
+  __m512i vTwice = _mm512_setzero_si512();
+  int k = 0;
+  for (; k + 8 <= count; k += 8) {
+    __m512i x = _mm512_loadu_si512(options + k);
+    vTwice = _mm512_or_si512(vTwice, _mm512_and_si512(vOnce, x));
+    vOnce = _mm512_or_si512(vOnce, x);
+  }
+  uint64_t laneOnce[8], laneTwice[8];
+  _mm512_storeu_si512(laneOnce, vOnce);
+  _mm512_storeu_si512(laneTwice, vTwice);
+  mergeLanes(laneOnce, laneTwice, 8, once, twice);
+  onceTwiceScalar(options, (const int *)NULL, 0, 1, k, count, once, twice);
+}
+
+__attribute__((target("avx2")))
+inline int findSinglesAvx2(const uint32_t *options, const unsigned char *values, int count, int *out) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi32(1);
+  int found = 0;
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(options + i));
+    //x & (x - 1) == 0 iff x has at most one bit set
+    __m256i atMostOne = _mm256_cmpeq_epi32(_mm256_and_si256(x, _mm256_sub_epi32(x, one)), zero);
+    __m256i empty = _mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(values + i))), zero);
+    int hits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(atMostOne, empty)));
+    while (hits) {
+      out[found++] = i + __builtin_ctz(hits);
+      hits &= hits - 1;
+    }
+  }
+  return found + findSinglesScalar(options, values, i, count, out + found);
+}
+
+__attribute__((target("avx2")))
+inline int findSinglesAvx2(const uint64_t *options, const unsigned char *values, int count, int *out) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi64x(1);
+  int found = 0;
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(options + i));
+    __m256i atMostOne = _mm256_cmpeq_epi64(_mm256_and_si256(x, _mm256_sub_epi64(x, one)), zero);
+    int fourValues;
+    memcpy(&fourValues, values + i, 4);
+    __m256i empty = _mm256_cmpeq_epi64(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128(fourValues)), zero);
+    int hits = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_and_si256(atMostOne, empty)));
+    while (hits) {
+      out[found++] = i + __builtin_ctz(hits);
+      hits &= hits - 1;
+    }
+  }
+  return found + findSinglesScalar(options, values, i, count, out + found);
+}
+
+__attribute__((target("avx512f")))
+inline int findSinglesAvx512(const uint32_t *options, const unsigned char *values, int count, int *out) {
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i one = _mm512_set1_epi32(1);
+  int found = 0;
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m512i x = _mm512_loadu_si512(options + i);
+    __mmask16 atMostOne = _mm512_cmpeq_epi32_mask(_mm512_and_si512(x, _mm512_sub_epi32(x, one)), zero);
+    __mmask16 empty = _mm512_cmpeq_epi32_mask(_mm512_maskz_cvtepu8_epi32(0xFFFF, _mm_loadu_si128((const __m128i *)(values + i))), zero);
+    unsigned hits = atMostOne & empty;
+    while (hits) {
+      out[found++] = i + __builtin_ctz(hits);
+      hits &= hits - 1;
+    }
+  }
+  return found + findSinglesScalar(options, values, i, count, out + found);
+}
+
+__attribute__((target("avx512f")))
+inline int findSinglesAvx512(const uint64_t *options, const unsigned char *values, int count, int *out) {
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i one = _mm512_set1_epi64(1);
+  int found = 0;
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m512i x = _mm512_loadu_si512(options + i);
+    __mmask8 atMostOne = _mm512_cmpeq_epi64_mask(_mm512_and_si512(x, _mm512_sub_epi64(x, one)), zero);
+    __mmask8 empty = _mm512_cmpeq_epi64_mask(_mm512_maskz_cvtepu8_epi64(0xFF, _mm_loadl_epi64((const __m128i *)(values + i))), zero);
+    unsigned hits = atMostOne & empty;
+    while (hits) {
+      out[found++] = i + __builtin_ctz(hits);
+      hits &= hits - 1;
+    }
+  }
+  return found + findSinglesScalar(options, values, i, count, out + found);
+}
+
+#endif
+
+/* once gets the OR of the choices of the count cells of a unit, twice the
+   choices seen in at least two of them */
+template <typename Mask>
+void onceTwice(const Mask *options, const int *cells, int start, int stride, int count, Mask &once, Mask &twice) {
+  once = 0;
+  twice = 0;
+  onceTwiceScalar(options, cells, start, stride, 0, count, once, twice);
+}
+
+template <typename Word>
+void onceTwiceWord(const Word *options, const int *cells, int start, int stride, int count, Word &once, Word &twice) {
+  once = 0;
+  twice = 0;
+#ifdef HAVE_X86_SIMD
+  //units shorter than a 512 bit vector still fill a 256 bit one
+  if (simdLevel == SIMD_AVX512 && !cells && stride == 1 && count >= (int)(64 / sizeof(Word))) {
+    return onceTwiceAvx512(options + start, count, once, twice);
+  }
+  if (simdLevel >= SIMD_AVX2) return onceTwiceAvx2(options, cells, start, stride, count, once, twice);
+#endif
+  onceTwiceScalar(options, cells, start, stride, 0, count, once, twice);
+}
+
+inline void onceTwice(const uint32_t *options, const int *cells, int start, int stride, int count,
+                      uint32_t &once, uint32_t &twice) {
+  onceTwiceWord(options, cells, start, stride, count, once, twice);
+}
+
+inline void onceTwice(const uint64_t *options, const int *cells, int start, int stride, int count,
+                      uint64_t &once, uint64_t &twice) {
+  onceTwiceWord(options, cells, start, stride, count, once, twice);
+}
+
+//write to out the empty cells with one choice or none left, return how many there are
+template <typename Mask>
+int findSingles(const Mask *options, const unsigned char *values, int count, int *out) {
+  int found = 0;
+  for (int i = 0; i < count; i++) {
+    if (!values[i] && popCount(options[i]) <= 1) out[found++] = i;
+  }
+  return found;
+}
+
+template <typename Word>
+int findSinglesWord(const Word *options, const unsigned char *values, int count, int *out) {
+#ifdef HAVE_X86_SIMD
+  if (simdLevel == SIMD_AVX512) return findSinglesAvx512(options, values, count, out);
+  if (simdLevel == SIMD_AVX2) return findSinglesAvx2(options, values, count, out);
+#endif
+  return findSinglesScalar(options, values, 0, count, out);
+}
+
+inline int findSingles(const uint32_t *options, const unsigned char *values, int count, int *out) {
+  return findSinglesWord(options, values, count, out);
+}
+
+inline int findSingles(const uint64_t *options, const unsigned char *values, int count, int *out) {
+  return findSinglesWord(options, values, count, out);
+}
+
+#endif
@@ -8,21 +8,49 @@
 #include <cstdlib>
 #include <cstring>
 #include <assert.h>
+#include <atomic>
 #include <omp.h>
+#include <thread>
 
 #include "mic.h"
+#include "bitboard.h"
+#include "deque.h"
+#include "dlx.h"
+#include "humanistic.h"
 #include <math.h> 
 #include <string>
-#include <stack>
 using namespace std;
 
 #define BUFSIZE 1024
-//number of bits (least significant) used to store the real value of the board cell
-#define VALUEBITS 5
+
+//search engines selectable with -e, auto picks bitboard for 9x9 boards and stack otherwise
+enum Engine { ENGINE_AUTO, ENGINE_STACK, ENGINE_DLX, ENGINE_BITBOARD, ENGINE_PORTFOLIO };
+
+/* configurations raced by the portfolio engine. thread 0 keeps the one given
+   on the command line, thread t > 0 runs portfolio[(t - 1) % PORTFOLIO_SIZE]
+   with -seed + t */
+struct PortfolioConfig {
+  const char *preset;
+  const char *order;
+  bool branchOnUnits;
+};
+#define PORTFOLIO_SIZE 8
+static const PortfolioConfig portfolio[PORTFOLIO_SIZE] = {
+  {"balanced", "lcv", true},
+  {"cheap", "random", true},
+  {"full", "asc", false},
+  {"balanced", "random", false},
+  {"cheap", "lcv", false},
+  {"full", "random", true},
+  {"cheap", "asc", true},
+  {"balanced", "asc", false},
+};
 
 static int _argc;
 static const char **_argv;
-typedef stack<int*> BoardStack;
+//one work-stealing deque of boards per thread
+template <int N>
+using BoardDeque = WorkDeque<Board<N>*>;
 
 /* Starter code function, don't touch */
 const char *get_option_string(const char *option_name,
@@ -60,953 +88,234 @@ static void show_help(const char *program_path)
     printf("OPTIONS:\n");
     printf("\t-f <input_filename> (required)\n");
     printf("\t-n <num_of_threads> (required)\n");
-}
-
-std::string cellToString(int cell, int boardSize){
-  cell = cell >> VALUEBITS;
-  std::string s = "";
-  for (int i = 0; i<= boardSize; i++){
-    if (cell & 1){
-      s += std::to_string(i)+"";
-    }
-    else{
-      s += " ";
-    }
-    cell = cell >>1;
-  }
-  return s;
-}
-void printBoard(int *board, int boardSize) {
-  printf("\n\n\n");
-  for (int r = 0; r < boardSize; r++) {
-    if ((r % (int)sqrt(boardSize)) == 0){
-      for (int i = 0; i < boardSize; i++) printf(" ____%d_____ ",r*boardSize +i);
-      printf("\n");
-    }
-    for (int c = 0; c < boardSize; c++)
-    {
-      std::string str = cellToString(board[r*boardSize + c],boardSize);
-      printf("%s | ", str.c_str());
-    }
-    printf("\n");
-  }
-}
-
-
-int maxInt(int a, int b) { return (a > b)? a : b; }
-int minInt(int a, int b) { return (a < b)? a : b; }
-
-bool isEmpty(int cell){
-  // returns true if value is not set yet, false otherwise
-  int allOnes = (1 << (VALUEBITS+1)) -1;
-  return !((cell & allOnes));
-}
-
-void checkRows(int *board, int boardSize, bool &correctness){
-
-  for (int r = 0; r < boardSize*boardSize; r += boardSize)
-  {
-    // Compare every 2 distenct cells
-    for (int i = 0; i < boardSize-1; i++)
-    {
-      int A = r+i;
-      int cellA = board[A];
-      if (!isEmpty(cellA)){
-        for (int j = i+1; j < boardSize; j++)
-        {
-          int B = r+j;
-          int cellB = board[B];
-          if (cellB == cellA){
-            correctness = false;
-          }
-        }
-      }
-    }
-  }
-}
-void checkBoxes(int *board, int boardSize, bool &correctness){
-  int n = sqrt(boardSize);
-  for (int bx = 0; bx < n; bx++)
-  {
-    for (int by = 0; by < n; by++)
-    {
-      int box_index = bx*n*boardSize + by*n;
-      // Compare every 2 distenct cells
-      for (int i = 0; i < boardSize -1; i++)
-      {
-        int A = ((i/n))*boardSize + (i%n) + box_index;
-        int cellA = board[A];
-        if (!isEmpty(cellA)){
-          for (int j = i+1; j < boardSize; j++)
-          {
-            int B = ((j/n))*boardSize + (j%n) + box_index;
-            int cellB = board[B];
-            if (cellB == cellA){
-              correctness = false;
-            }
-          }
-        }
-      }
-    }
-  }
-}
-
-void checkColumns(int *board, int boardSize, bool &correctness){
-  for (int c = 0; c < boardSize; c++)
-  {
-    // Compare every 2 distenct cells
-    for (int i = 0; i < boardSize-1; i++)
-    {
-      int A = i*boardSize + c;
-      int cellA = board[A];
-      if (!isEmpty(cellA)){
-        for (int j = i+1; j < boardSize; j++)
-        {
-          int B = j*boardSize + c;
-          int cellB = board[B];
-          if (cellB == cellA){
-            correctness = false;
-          }
-        }
-      }
-    }
-  }
-}
-
-void compareToOriginal(int *board, int *originalBoard, int boardSize, bool &correctness) {
-  for (int i = 0; i < boardSize * boardSize; ++i)
-  {
-    if (originalBoard[i] % (1 << VALUEBITS)) {
-      if (originalBoard[i] != board[i]) {
-        correctness = false;
-        return;
-      }
-    }
-  }
-}
-
-void correctnessChecker(int *board, int *originalBoard, int boardSize){
-  if (board == NULL) {
-    printf("No Solution\n");
-    return;
-  }
-
-  bool correctness = true;
-  checkRows(board, boardSize, correctness);
-  checkColumns(board, boardSize, correctness);
-  checkBoxes(board, boardSize, correctness);
-
-  compareToOriginal(board, originalBoard, boardSize, correctness);
-
-  if (correctness){
-    printf("\n\nCorrectness: True\n");
-  }
-  else
-  {
-    printf("\n\nCorrectness: False\n");
-  }
-}
-void addToBoard(int num, int i, int *board, int boardSize) {
-  /*temporary storage for the bitvector specifying what number choices still open for
-    that spot on the board */
-  int choices;
-  if (num) {
-    //num != 0
-    //fixed number on sudoku board, so only 1 choice for the number
-    choices = 1 << num;
-
-  } else {
-    //num == 0
-    //blank number on sudoku board, so can be any number
-    choices = ((1 << boardSize) - 1) << 1;
-  }
-  board[i] = (choices << VALUEBITS) + num;
-}
-
-void writeFile(FILE *output_file, int *board, int i) {
-  fprintf(output_file, "%02d ", board[i] % (1<<VALUEBITS));
-}
-
-void eliminateChoices(int *board, int boardSize, int row, int col, int n) {
-  //number to eliminate as option from relevant cells
-  int num = board[row * boardSize + col] % (1<<VALUEBITS);
-  //filter for removing options from cells
-  int filter = ~(1 << (VALUEBITS + num));
-  for (int rowI = 0; rowI < boardSize; rowI++) {
-    //eliminate choices for the column
-    if (rowI != row) {
-      int i = rowI * boardSize + col;
-      board[i] = board[i] & filter; 
-    }
-  }
-
-  for (int colI = 0; colI < boardSize; colI++) {
-    //eliminate choices for the row
-    if (colI != col) {
-      int i = row * boardSize + colI;
-      board[i] = board[i] & filter; 
-    }
-  }
-
-  /*base row and col for the square the cell is located in
-   (the index of upper-right corner of the square) */
-  int baseRow = row / n * n;
-  int baseCol = col / n * n;
-  for (int squareI = 0; squareI < boardSize; squareI++){
-    //eliminate choices for the square
-    int squareRow = baseRow + squareI / n;
-    int squareCol = baseCol + squareI % n;
-    if (squareCol != col || squareRow != row) {
-      int i = squareRow * boardSize + squareCol;
-      board[i] = board[i] & filter;
-    }
-  }
-}
-int log2(int n) {
-  //REQUIRES: n is a power of 2, n != 0
-  int log = 0;
-  while (n >>= 1) ++log;
-  return log;
-}
-
-bool elimination(int *board, int boardSize, bool &cellChanged, int n) {
-  //return false iff the board given has no valid solution
-  for (int i = 0; i < boardSize * boardSize; i++) {
-    int value = board[i];
-    if (!(value % (1<<VALUEBITS))) {
-      //cell is currently empty
-      value = value >> VALUEBITS;
-      //all the choice bits are 0, so no solution to board
-      if (!value) return false;
-
-      if (!(value & (value - 1))) {
-        //value is a power of 2, aka there is only one value this cell can take
-        cellChanged = true;
-        board[i] += log2(value);
-        eliminateChoices(board, boardSize, i / boardSize, i % boardSize, n);
-      }
-    }
-  }
-  return true;
-}
-
-
-void loneRanger(int *board, int boardSize, bool &cellChanged, int n) {
-  for (int i = 0; i < boardSize * boardSize; i++) {
-    int value = board[i];
-    if (!(value % (1<<VALUEBITS))) {
-
-      //cell is currently empty
-      int row = i / boardSize;
-      int col = i % boardSize;
-
-      //create a mask to find which choices the other cells in col have
-      int mask = 0;
-      for (int rowI = 0; rowI < boardSize; rowI++) {
-        if (rowI != row) mask = mask | board[rowI * boardSize + col];
-      }
-
-      //mask out the choices of the other cells in col
-      value = value & (~mask);
-
-      //if value still has 1 choice
-      if (value && !(value & (value - 1))) {
-        cellChanged = true;
-        //write choice to cell and eliminate choices from relevant cells
-        board[i] = value + log2(value) - VALUEBITS;
-        eliminateChoices(board, boardSize, row, col, n);
-        continue;
-      }
-
-      //do the same for rows and blocks
-      value = board[i];
-      mask = 0;
-      for (int colI = 0; colI < boardSize; colI++) {
-        if (colI != col) {
-          mask = mask | board[row * boardSize + colI];
-        }
-      }
-
-      value = value & (~mask);
-
-      if (value && !(value & (value - 1))) {
-        cellChanged = true;
-        board[i] = value + log2(value) - VALUEBITS;
-        eliminateChoices(board, boardSize, row, col, n);
-        continue;
-      }
-
-      /*base row and col for the square the cell is located in
-       (the index of upper-right corner of the square) */
-      int baseRow = row / n * n;
-      int baseCol = col / n * n;
-
-      value = board[i];
-      mask = 0;
-      for (int squareI = 0; squareI < boardSize; squareI++){
-        int squareRow = baseRow + squareI / n;
-        int squareCol = baseCol + squareI % n;
-        if (squareCol != col || squareRow != row) {
-          mask = mask | board[squareRow * boardSize + squareCol];
-        }
-      }
-      
-      value = value & (~mask);
-
-      if (value && !(value & (value - 1))) {
-        cellChanged = true;
-        board[i] = value + log2(value) - VALUEBITS;
-        eliminateChoices(board, boardSize, row, col, n);
-      }
-    }
-  }
-}
-
-int getCellOptions(int cellA){
-  //returns the options part only 
-  return cellA >> VALUEBITS;
-}
-
-void setOptions(int *board, int index, int options){
-  board[index] = options << VALUEBITS;
-}
-
-void removeOption(int *board, int index, int option){
-  int mask = ~(1 << (option + VALUEBITS));
-  board[index] = board[index] & mask;
-}
-
-int hasOption(int cell, int option){
-  return cell & (1 << (option + VALUEBITS));
-}
-
-void eliminateFromBoxRow(int *board, int boxSize ,int index, int option, bool &choicesChanged){
-  for (int col = 0; col < boxSize; col++)
-  {
-    if (hasOption(board[index + col],option))
-    { 
-      choicesChanged = true;
-      removeOption(board, index + col, option);
-
-    }
-  }
-}
-void eliminateFromBoxCol(int *board, int boardsize, int boxSize ,int index, int option, bool &choicesChanged){
-  for (int row = 0; row < boxSize; row++)
-  {
-    if (hasOption(board[index + row*boardsize],option))
-    { 
-      choicesChanged = true;
-      removeOption(board, index + row*boardsize, option);
+    printf("\t-e <auto|stack|dlx|bitboard|portfolio> (default auto: bitboard for 9x9, stack otherwise.\n");
+    printf("\t   dlx and bitboard run on one thread, bitboard only solves 9x9.\n");
+    printf("\t   portfolio races a differently configured search on every thread)\n");
+    printf("\t-preset <cheap|balanced|full> (default balanced)\n");
+    printf("\t-k <max_subset_size> (default 3, 1 disables naked/hidden subsets)\n");
+    printf("\t-fish <max_fish_size> (default by board size, 1 disables fish)\n");
+    printf("\t-stats 1 (print strategy counters)\n");
+    printf("\t-simd <auto|scalar|avx2|avx512> (default auto)\n");
+    printf("\t-order <asc|lcv|random> (default asc, order the alternatives of a branch are tried in)\n");
+    printf("\t-seed <seed> (default time, seed of -order random)\n");
+    printf("\t-count [limit] (count solutions with the stack engine, stopping at limit.\n");
+    printf("\t   no limit or 0 counts all, 2 checks uniqueness)\n");
+}
+
+//solutions counted by one thread, on its own cache line
+struct alignas(CACHE_LINE) SolutionCounter {
+  std::atomic<long> solutions;
+};
+
+/* what the threads of the stack solver share: their deques, how many boards
+   are still to be searched, and the solution once one is found */
+template <int N>
+struct SearchState {
+  BoardDeque<N> *deques;
+  //boards pushed and not searched to the end yet, the search is over when it reaches 0
+  std::atomic<long> outstanding;
+  //set once a solution is published or no board is left
+  std::atomic<bool> stop;
+  //first solution found, NULL if there is none
+  std::atomic<Board<N> *> solution;
+  //when the solution was published, to measure how long the other threads take to stop
+  std::chrono::high_resolution_clock::time_point solvedAt;
+  //every thread searches the whole board on its own, nothing is shared
+  bool portfolio;
+  //thread that ended the portfolio race
+  int winner;
+  //count solutions instead of stopping at the first, up to countLimit unless it is 0
+  bool counting;
+  long countLimit;
+  SolutionCounter *counters;
+};
+
+template <int N>
+bool shareWork(SearchState<N> &state) {
+  //true iff the deque of the thread has nothing left for idle threads to steal
+  if (state.portfolio || omp_get_num_threads() == 1) return false;
+  return !dequeSize(state.deques[omp_get_thread_num()]);
+}
+
+template <int N>
+long countedSolutions(SearchState<N> &state) {
+  //solutions counted so far by all the threads
+  long total = 0;
+  for (int t = 0; t < omp_get_num_threads(); t++) total += state.counters[t].solutions.load(std::memory_order_relaxed);
+  return total;
+}
+
+template <int N>
+void countSolution(Board<N> *board, SearchState<N> &state) {
+  //count solved board on the thread's counter, keep a copy of the first, stop once the limit is reached
+  std::atomic<long> &own = state.counters[omp_get_thread_num()].solutions;
+  own.store(own.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  if (!state.solution.load(std::memory_order_relaxed)) {
+    //the board is searched on in place, so the solution is copied
+    Board<N> *copy = copyBoard(board);
+    Board<N> *none = NULL;
+    if (state.solution.compare_exchange_strong(none, copy, std::memory_order_acq_rel)) {
+      state.solvedAt = std::chrono::high_resolution_clock::now();
+    } else {
+      freeBoard(copy);
     }
   }
-}
-
-void boxElimination(int *board, int boardSize, bool &choicesChanged, int n){
-  for (int bx = 0; bx < n; bx++)
-  {
-    for (int by = 0; by < n; by++)
-    {
-      int box_index = bx*n*boardSize + by*n;
-      // Compare every 2 distenct cells
-      for (int option = 1; option <= boardSize; option++){
-        int row = -1; //uninitialized
-        int col = -1; //uninitialized
-        bool optionOnRow = true;
-        bool optionOnCol = true;
-        for (int i = 0; i < boardSize; i++){
-          int A = ((i/n))*boardSize + (i%n) + box_index;
-          int cellA = board[A];
-          if (isEmpty(cellA)){ //avoid already set cells
-            if (hasOption(cellA, option)){
-              if (row == -1) {
-                row = i/n;
-                col = i%n;
-              } 
-              if (row != i/n) optionOnRow = false;
-              if (col != i%n) optionOnCol = false;
-            }
-          }
-        }
-        if (row != -1 && optionOnRow){
-          for (int j = 0; j < n; j++)
-          {
-            if (j != by) eliminateFromBoxRow(board, n, bx*n*boardSize + row*boardSize + j*n,option, choicesChanged);
-          }
-        }
-        if (col != -1 && optionOnCol){
-          for (int j = 0; j < n; j++)
-          {
-            if (j != bx) eliminateFromBoxCol(board, boardSize, n, j*n*boardSize + by*n + col,option, choicesChanged);
-          }
-        }
+  if (state.countLimit && countedSolutions(state) >= state.countLimit) state.stop.store(true, std::memory_order_release);
+}
+
+template <int N>
+Board<N> *searchInPlace(Board<N> *board, SearchState<N> &state) {
+  /* depth first search of board, undoing each branch from the trail of the
+     board instead of copying it. while the deque of the thread is empty the
+     other alternatives of a branch are copied onto it for idle threads to
+     steal. return board solved, or NULL. when counting, solutions are
+     counted and the search goes on, so NULL is returned */
+  const int boardSize = N * N;
+  if (!board->emptyCells) {
+    //No empty cell is left, board is solved!
+    if (!state.counting) return board;
+    countSolution(board, state);
+    return NULL;
+  }
+  if (cancelled()) return NULL;
+
+  //branch on the most constrained cell, or on where a number goes in a unit
+  int cells[boardSize];
+  int nums[boardSize];
+  int numChoices = branchChoices(board, cells, nums);
+  if (numChoices > 1 && shareWork(state)) {
+    //push the preferred alternatives last, so that they are popped first
+    for (int c = numChoices - 1; c >= 1; c--) {
+      Board<N> *newBoard = copyBoard(board);
+      if (!setValue(newBoard, cells[c], nums[c]) || !humanistic(newBoard, cells[c])){
+        //no solution exists
+        freeBoard(newBoard);
+        continue;//discard it
       }
+      //counted before it can be taken, so the count can't reach 0 while the board is out
+      state.outstanding.fetch_add(1, std::memory_order_relaxed);
+      dequePush(state.deques[omp_get_thread_num()], newBoard);
     }
+    numChoices = 1;
   }
-}
-/*
- * bitCount - returns count of number of 1's in word
- *   Examples: bitCount(5) = 2, bitCount(7) = 3
- * Fast bitcount oshafie 15213's datalab
- */
-int bitCount(int x) {
-  int everyOtherTemp = (0x55 << 8) +(0x55);
-  int everyOther = (everyOtherTemp << 16) +(everyOtherTemp);//6
-  int every2Temp = (0x33 << 8) +(0x33);
-  int every2 = (every2Temp << 16) + every2Temp;
-  int every4Temp = (0xf << 8) +(0xf);
-  int every4 = (every4Temp << 16) + every4Temp;//6
-  int every8 = (0xff << 16) +(0xff);//2
-  int every16 = (0xff << 8) +(0xff);//2
-  x = (x & everyOther) + ((x >> 1) & everyOther);//4
-  x = (x & every2) + ((x >> 2) & every2);//4
-  x = (x & every4) + ((x >> 4) & every4);//4
-  x = (x & every8) + ((x >> 8) & every8);//4
-  return (x & every16) + ((x >> 16)& every16);//4
-}
-
-void twinsInRow(int *board, int boardSize, bool &choicesChanged){
-  // We could assume that every empty cell has at least 2 options, therefore no need for filtering (2+)-option cells
-  int A;
-  int cellA;
-  int B;
-  int cellB;
-  // Find twins per row
-  for (int r = 0; r < boardSize; r++)
-  {
-    // Compare every 2 distenct cells
-    for (int i = 0; i < boardSize-1; i++)
-    {
-      A = (r*boardSize) +i;
-      cellA = board[A];
-      if (isEmpty(cellA)){ //avoid already set cells
-        cellA = getCellOptions(cellA);
-        for (int j = i+1; j < boardSize; j++)
-        {
-          B = (r*boardSize)+j;
-          cellB = board[B];
-          if (isEmpty(cellB)){ //avoid already set cells
-            cellB = getCellOptions(cellB);
-            // cellA and cellB are twins if cellA & cellB has exactly 2 options
-            int options = cellA & cellB;
-            if (bitCount(options) >= 2){
-              //Check that no other cell have the any of the 2 options available
-              int optionsUnion = 0; // get all options for all left cells
-              for (int t = 0; t < boardSize; t++)
-              {
-                if (t != i && t != j){
-                  int tempCell = board[(r*boardSize)+t];
-                  optionsUnion = optionsUnion | getCellOptions(tempCell);
-                }
-              }
-              options = options & ~optionsUnion; // remove options that are in the union
-              if (bitCount(options) == 2){
-                if (options != cellA){
-                  setOptions(board, A, options);
-                  choicesChanged = true;
-                }
-                if (options != cellB){
-                  setOptions(board, B, options);
-                  choicesChanged = true;
-                }
-              }
-            }
-          }
-        }
-      }
+  for (int c = 0; c < numChoices; c++) {
+    size_t mark = board->trail->changes.size();
+    if (setValue(board, cells[c], nums[c]) && humanistic(board, cells[c])) {
+      if (searchInPlace(board, state)) return board;
     }
+    undoTrail(board, mark);
   }
+  return NULL; //there is no solution for the given board
 }
 
-void twinsInBox(int *board, int boardSize, bool &choicesChanged){
-  // We could assume that every empty cell has at least 2 options, therefore no need for filtering (2+)-option cells
-  int A;
-  int cellA;
-  int B;
-  int cellB;
-  int n = sqrt(boardSize);
-  // Find twins per box
-  for (int bx = 0; bx < n; bx++)
-  {
-    for (int by = 0; by < n; by++)
-    {
-      int box_index = bx*n*boardSize + by*n;
-      // Compare every 2 distenct cells
-      for (int i = 0; i < boardSize -1; i++)
-      {
-        A = ((i/n))*boardSize + (i%n) + box_index;
-        cellA = board[A];
-        if (isEmpty(cellA)){ //avoid already set cells
-          cellA = getCellOptions(cellA);
-          for (int j = i+1; j < boardSize; j++)
-          {
-            B = ((j/n))*boardSize + (j%n) + box_index;
-            cellB = board[B];
-            if (isEmpty(cellB)){ //avoid already set cells
-              cellB = getCellOptions(cellB);
-              // cellA and cellB are twins if cellA & cellB has exactly 2 options
-              int options = cellA & cellB;
-              if (bitCount(options) >= 2){
-                //Check that no other cell have the any of the 2 options available
-                int optionsUnion = 0; // get all options for all left cells
-                for (int t = 0; t < boardSize; t++)
-                {
-                  if (t != i && t != j){
-                    int tempCell = board[((t/n))*boardSize + (t%n) + box_index];
-                    optionsUnion = optionsUnion | getCellOptions(tempCell);
-                  }
-                }
-                options = options & ~optionsUnion; // remove options that are in the union
-                if (bitCount(options) == 2){
-                  if (options != cellA){
-                  setOptions(board, A, options);
-                  choicesChanged = true;
-                  }
-                  if (options != cellB){
-                    setOptions(board, B, options);
-                    choicesChanged = true;
-                  }
-                }
-              }
-            }
-          }
-        }
-      }
-    }
+template <int N>
+Board<N> *takeBoard(SearchState<N> &state) {
+  //the newest board of the thread's own deque, or the oldest of another thread's
+  int self = omp_get_thread_num();
+  int numThreads = omp_get_num_threads();
+  Board<N> *board = dequePop(state.deques[self]);
+  for (int k = 1; k < numThreads && !board; k++) {
+    board = dequeSteal(state.deques[(self + k) % numThreads]);
   }
+  return board;
 }
 
-void twinsInColumn(int *board, int boardSize, bool &choicesChanged){
-  // We could assume that every empty cell has at least 2 options, therefore no need for filtering (2+)-option cells
-  int A;
-  int cellA;
-  int B;
-  int cellB;
-  // Find twins per column
-  for (int c = 0; c < boardSize; c++)
-  {
-    // Compare every 2 distenct cells
-    for (int i = 0; i < boardSize-1; i++)
-    {
-      A = i*boardSize + c;
-      cellA = board[A];
-      if (isEmpty(cellA)){ //avoid already set cells
-        cellA = getCellOptions(cellA);
-        for (int j = i+1; j < boardSize; j++)
-        {
-          B = j*boardSize + c;
-          cellB = board[B];
-          if (isEmpty(cellB)){ //avoid already set cells
-            cellB = getCellOptions(cellB);
-            // cellA and cellB are twins if cellA & cellB has exactly 2 options
-            int options = cellA & cellB;
-            if (bitCount(options) >= 2){
-              //Check that no other cell have the any of the 2 options available
-              int optionsUnion = 0; // get all options for all left cells
-              for (int t = 0; t < boardSize; t++)
-              {
-                if (t != i && t != j){
-                  int tempCell = board[t*boardSize + c];
-                  optionsUnion = optionsUnion | getCellOptions(tempCell);
-                }
-              }
-              options = options & ~optionsUnion; // remove options that are in the union
-              if (bitCount(options) == 2){
-                if (options != cellA){
-                  setOptions(board, A, options);
-                  choicesChanged = true;
-                }
-                if (options != cellB){
-                  setOptions(board, B, options);
-                  choicesChanged = true;
-                }
-              }
-            }
-          }
-        }
-      }
-    }
-  }
-}
-
-void tripletsInRow(int *board, int boardSize, bool &choicesChanged){
-  // We could assume that every empty cell has at least 2 options, therefore no need for filtering (2+)-option cells
-  int A;
-  int cellA;
-  int B;
-  int cellB;
-  int C;
-  int cellC;
-  // Find twins per row
-  for (int r = 0; r < boardSize; r ++)
-  {
-    // Compare every 2 distenct cells
-    for (int i = 0; i < boardSize-2; i++)
-    {
-      A = r*boardSize+i;
-      cellA = board[A];
-      if (isEmpty(cellA)){ //avoid already set cells
-        cellA = getCellOptions(cellA);
-        for (int j = i+1; j < boardSize-1; j++)
-        {
-          B = r*boardSize+j;
-          cellB = board[B];
-          if (isEmpty(cellB)){ //avoid already set cells
-            cellB = getCellOptions(cellB);
-            for (int k = j+1; k < boardSize; k++)
-            {
-              C = r*boardSize+k;
-              cellC = board[C];
-              if (isEmpty(cellC)){ //avoid already set cells
-                cellC = getCellOptions(cellC);
-                // cellA, cellB and cellC are triplets if (cellA & cellB & cellC) has exactly 3 options
-                int options = cellA & cellB & cellC;
-                if (bitCount(options) >= 3){
-                  int optionsUnion = 0; // get all options for all left cells
-                  for (int t = 0; t < boardSize; t++)
-                  {
-                    if (t != i && t != j){
-                      int tempCell = board[r*boardSize+t];
-                      optionsUnion = optionsUnion | getCellOptions(tempCell);
-                    }
-                  }
-                  options = options & ~optionsUnion; // remove options that are in the union
-                  if (bitCount(options) == 3){
-                    if (options != cellA){
-                      setOptions(board, A, options);
-                      choicesChanged = true;
-                    }
-                    if (options != cellB){
-                      setOptions(board, B, options);
-                      choicesChanged = true;
-                    }
-                    if (options != cellC){
-                      setOptions(board, C, options);
-                      choicesChanged = true;
-                    }
-                  }
-                }
-              }
-            }
-          }
-        }
-      }
-    }
-  }
+inline void idleBackoff(int rounds) {
+  //spin a little, then yield, then sleep up to 256us so idle threads leave the cores alone
+  if (rounds < 8) return;
+  if (rounds < 16) std::this_thread::yield();
+  else std::this_thread::sleep_for(std::chrono::microseconds(1 << (rounds < 24 ? rounds - 16 : 8)));
 }
 
-void tripletsInBox(int *board, int boardSize, bool &choicesChanged){
-  // We could assume that every empty cell has at least 2 options, therefore no need for filtering (2+)-option cells
-  int A;
-  int cellA;
-  int B;
-  int cellB;
-  int C;
-  int cellC;
-  int n = sqrt(boardSize);
-  // Find twins per box
-  for (int bx = 0; bx < n; bx++)
-  {
-    for (int by = 0; by < n; by++)
-    {
-      int box_index = bx*n*boardSize + by*n;
-      // Compare every 2 distenct cells
-      for (int i = 0; i < boardSize -2; i++)
-      {
-        A = ((i/n))*boardSize + (i%n) + box_index;
-        cellA = board[A];
-        if (isEmpty(cellA)){ //avoid already set cells
-          cellA = getCellOptions(cellA);
-          for (int j = i+1; j < boardSize -1; j++)
-          {
-            B = ((j/n))*boardSize + (j%n) + box_index;
-            cellB = board[B];
-            if (isEmpty(cellB)){ //avoid already set cells
-              cellB = getCellOptions(cellB);
-              for (int k = j+1; k < boardSize; k++)
-              {
-                C = ((k/n))*boardSize + (k%n) + box_index;
-                cellC = board[C];
-                if (isEmpty(cellC)){ //avoid already set cells
-                  cellC = getCellOptions(cellC);
-                  // cellA, cellB and cellC are triplets if (cellA & cellB & cellC) has exactly 3 options
-                  int options = cellA & cellB & cellC;
-                  if (bitCount(options) >= 3){
-                    int optionsUnion = 0; // get all options for all left cells
-                    for (int t = 0; t < boardSize; t++)
-                    {
-                      if (t != i && t != j){
-                        int tempCell = board[((t/n))*boardSize + (t%n) + box_index];
-                        optionsUnion = optionsUnion | getCellOptions(tempCell);
-                      }
-                    }
-                    options = options & ~optionsUnion; // remove options that are in the union
-                    if (bitCount(options) == 3){
-                      if (options != cellA){
-                        setOptions(board, A, options);
-                        choicesChanged = true;
-                      }
-                      if (options != cellB){
-                        setOptions(board, B, options);
-                        choicesChanged = true;
-                      }
-                      if (options != cellC){
-                        setOptions(board, C, options);
-                        choicesChanged = true;
-                      }
-                    }
-                  }
-                }
-              }
-            }
-          }
-        }
-      }
+template <int N>
+void stackedBruteForce(SearchState<N> &state, Trail<N> &trail) {
+  //search boards until a solution is published or every board was searched
+  int idle = 0;
+  while (!state.stop.load(std::memory_order_acquire)) {
+    Board<N> *board = takeBoard(state);
+    if (!board) {
+      //no board anywhere and none being searched: there is no solution
+      if (!state.outstanding.load(std::memory_order_acquire)) state.stop.store(true, std::memory_order_release);
+      idleBackoff(idle++);
+      continue;
     }
-  }
-}
-void tripletsInColumn(int *board, int boardSize, bool &choicesChanged){
-  // We could assume that every empty cell has at least 2 options, therefore no need for filtering (2+)-option cells
-  int A;
-  int cellA;
-  int B;
-  int cellB;
-  int C;
-  int cellC;
-  // Find twins per column
-  for (int c = 0; c < boardSize; c++)
-  {
-    // Compare every 2 distenct cells
-    for (int i = 0; i < boardSize-2; i++)
-    {
-      A = i*boardSize + c;
-      cellA = board[A];
-      if (isEmpty(cellA)){ //avoid already set cells
-        cellA = getCellOptions(cellA);
-        for (int j = i+1; j < boardSize-1; j++)
-        {
-          B = j*boardSize + c;
-          cellB = board[B];
-          if (isEmpty(cellB)){ //avoid already set cells
-            cellB = getCellOptions(cellB);
-            for (int k = j+1; k < boardSize; k++)
-            {
-              C = k*boardSize + c;
-              cellC = board[C];
-              if (isEmpty(cellC)){ //avoid already set cells
-                cellC = getCellOptions(cellC);
-                // cellA, cellB and cellC are triplets if (cellA & cellB & cellC) has exactly 3 options
-                int options = cellA & cellB & cellC;
-                if (bitCount(options) >= 3){
-                  int optionsUnion = 0; // get all options for all left cells
-                  for (int t = 0; t < boardSize; t++)
-                  {
-                    if (t != i && t != j){
-                      int tempCell = board[t*boardSize + c];
-                      optionsUnion = optionsUnion | getCellOptions(tempCell);
-                    }
-                  }
-                  options = options & ~optionsUnion; // remove options that are in the union
-                  if (bitCount(options) == 3){
-                    if (options != cellA){
-                      setOptions(board, A, options);
-                      choicesChanged = true;
-                    }
-                    if (options != cellB){
-                      setOptions(board, B, options);
-                      choicesChanged = true;
-                    }
-                    if (options != cellC){
-                      setOptions(board, C, options);
-                      choicesChanged = true;
-                    }
-                  }
-                }
-              }
-            }
-          }
-        }
+    idle = 0;
+
+    //the thread searches the board in place, logging its changes to its own trail
+    board->trail = &trail;
+    trail.changes.clear();
+    Board<N> *solution = searchInPlace(board, state);
+    board->trail = NULL;
+    if (solution) {
+      //the first solution wins, the others are dropped with the pools
+      Board<N> *none = NULL;
+      if (state.solution.compare_exchange_strong(none, solution, std::memory_order_acq_rel)) {
+        state.solvedAt = std::chrono::high_resolution_clock::now();
       }
+      state.stop.store(true, std::memory_order_release);
+    } else {
+      //the board was searched to the end, it is no longer needed
+      freeBoard(board);
     }
-  }
-}
-
-void twins(int *board, int boardSize, bool &choicesChanged) {
-  twinsInRow(board, boardSize, choicesChanged);
-  twinsInBox(board, boardSize, choicesChanged);//Some overlapping work will occur
-  twinsInColumn(board, boardSize, choicesChanged);
-}
-
-void triplets(int *board, int boardSize, bool &choicesChanged) {
-  tripletsInRow(board, boardSize, choicesChanged);
-  tripletsInBox(board, boardSize, choicesChanged);//Some overlapping work will occur
-  tripletsInColumn(board, boardSize, choicesChanged);
-}
-
-bool humanistic(int *board, int boardSize, int n) {
-  /* return false if board has no solution
-     otherwise (i.e. if solution found or algorithm makes no more changes) return true */
-
-  //in some step of algorithm, a cell was written to with its final value
-  bool cellChanged = true;
-  //in some step of algorithm, choices were eliminated from some cell
-  bool choicesChanged = true;
-  while (cellChanged || choicesChanged) {
-    if (cellChanged) {
-      cellChanged = false;
-      if (!elimination(board, boardSize, cellChanged, n)) return false;
-      if (cellChanged) continue;
-    }
-    if (choicesChanged) {
-      loneRanger(board, boardSize, cellChanged, n);
-      if (cellChanged) continue;
-      choicesChanged = false;
-      boxElimination(board, boardSize, choicesChanged, n);
-      if (choicesChanged) continue;
-      twins(board, boardSize, choicesChanged);
-      if (choicesChanged) continue;
-      triplets(board, boardSize, choicesChanged);
-    }
-  }
-  return true;
-}
-
-int *stackedBruteForce(int boardSize, int n, BoardStack &bStack, omp_lock_t &stackLock) {
-  int *board;
-  omp_set_lock(&stackLock);
-  if (bStack.empty())
-  {
-    board = NULL;
-  }
-  else
-  {
-    board = bStack.top();
-    bStack.pop();
-  }
-  omp_unset_lock(&stackLock);
-  if (!board) return NULL;
-
-  int totalSquares = boardSize * boardSize;
-  for (int i=0; i < totalSquares; i++) {
-    int value = board[i];
-    if (!(value % (1<<VALUEBITS))) { //cell is empty
-      value = value >> VALUEBITS;
-      int choice = 0;
-      while (value) {
-        value = value>>1;
-        choice++;
-        if (value % 2) {
-          //printf("choice: %d\n", choice);
-          int *newBoard = (int *)calloc(totalSquares, sizeof(int));
-          memcpy(newBoard, board, totalSquares * sizeof(int));
-          newBoard[i] = (1 << (VALUEBITS + choice)) + choice;
-          //printBoard(newBoard, boardSize);
-          eliminateChoices(newBoard, boardSize, i / boardSize, i % boardSize, n);
-          if (!humanistic(newBoard, boardSize, n)){
-            //no solution exists
-            free(newBoard);
-            continue;//discard it
-          }
-          omp_set_lock(&stackLock);
-          bStack.push(newBoard);
-          omp_unset_lock(&stackLock);
-        }
-      }
-      //free(board);
-      return NULL; //there is no solution for the given board
+    state.outstanding.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+template <int N>
+void portfolioSearch(Board<N> *root, SearchState<N> &state, Trail<N> &trail) {
+  //search a copy of root with the configuration of the thread, the first to finish ends the race
+  int t = omp_get_thread_num();
+  if (t > 0) {
+    const PortfolioConfig &config = portfolio[(t - 1) % PORTFOLIO_SIZE];
+    setPreset(config.preset);
+    setValueOrder(config.order);
+    branchOnUnits = config.branchOnUnits;
+    randomSeed += t;
+  }
+  Board<N> *board = copyBoard(root);
+  board->trail = &trail;
+  Board<N> *solution = searchInPlace(board, state);
+  board->trail = NULL;
+  //a search cancelled by the winner found nothing either way
+  if (solution || !state.stop.load(std::memory_order_acquire)) {
+    //a solution, or the proof that there is none
+    bool first = !state.stop.exchange(true, std::memory_order_acq_rel);
+    if (first) {
+      state.solution.store(solution, std::memory_order_release);
+      state.solvedAt = std::chrono::high_resolution_clock::now();
+      state.winner = t;
     }
   }
-  return board;//No empty cell is found, board is solved!
 }
 
-void initialChoiceElm(int *board, int boardSize, int n) {
-  //n is square root of board size
-  for (int row = 0; row < boardSize; row++) {
-    for (int col = 0; col < boardSize; col++) {
-      int i = row * boardSize + col;
-      if (board[i] % (1<<VALUEBITS)) {
-        //if the cell in the board has a value
-        eliminateChoices(board, boardSize, row, col, n);
-      }
-    }
-  }
-}
-int main(int argc, const char *argv[])
+template <int N>
+int solveSudoku(FILE *input, const char *input_filename, int num_of_threads, int engine,
+                std::chrono::high_resolution_clock::time_point init_start)
 {
   using namespace std::chrono;
   typedef std::chrono::high_resolution_clock Clock;
   typedef std::chrono::duration<double> dsec;
 
-  auto init_start = Clock::now();
   double init_time = 0;
- 
-  _argc = argc - 1;
-  _argv = argv + 1;
-
-  srand(time(NULL));
-
-  /* You'll want to use these parameters in your algorithm */
-  const char *input_filename = get_option_string("-f", NULL);
-  int num_of_threads = get_option_int("-n", 1);
-
-  int error = 0;
-
-  if (input_filename == NULL) {
-    printf("Error: You need to specify -f.\n");
-    error = 1;
-  }
-
-  if (error) {
-    show_help(argv[0]);
-    return 1;
-  }
-  
-  printf("Number of threads: %d\n", num_of_threads);
-  printf("Input file: %s\n", input_filename);
-
-  FILE *input = fopen(input_filename, "r");
-
-  if (!input) {
-    printf("Unable to open file: %s.\n", input_filename);
-    return -1;
-  }
- 
-  //size of sudoku board is n^2 x n^2
-  int n;
 
-  fscanf(input, "%d\n", &n);
+  const int boardSize = N * N;
 
-  int boardSize = n*n;
+  //unit and peer tables used by every strategy
+  Topology<N>::build();
 
-  int *board = (int *)calloc(boardSize * boardSize, sizeof(int));
-  
+  Board<N> *board = readBoard<N>(input);
 
-  //for parsing sudoku board
-  int num;
- 
-  for (int row = 0; row < boardSize; row++) {
-    for (int col = 0; col < boardSize; col++) {
-      int i = row * boardSize + col;
-      fscanf(input, "%d", &num);
-      addToBoard(num, i, board, boardSize);
-    }
-    fscanf(input, "\n");
-  }
-
-  int *originalBoard = (int *)calloc(boardSize * boardSize, sizeof(int)); 
-  memcpy(originalBoard, board, boardSize * boardSize * sizeof(int));
+  Board<N> *originalBoard = copyBoard(board);
 
 
   /* Initialize additional data structures needed in the algorithm 
    * here if you feel it's needed. */
 
   //do initial choice elimination based on given board
-  initialChoiceElm(board, boardSize, n);
+  initialChoiceElm(board);
 
 
 
-  error = 0;
-
   init_time += duration_cast<dsec>(Clock::now() - init_start).count();
   printf("Initialization Time: %lf.\n", init_time);
   auto compute_start = Clock::now();
@@ -1014,6 +323,14 @@ int main(int argc, const char *argv[])
 
   //store whether the sudoku has a solution or not
   bool solution = true;
+  //-count: solutions found and whether the search stopped at the limit
+  int countLimit = get_option_int("-count", -1);
+  long solutionCount = 0;
+  bool limitReached = false;
+
+  //the board is transfered as one block of bytes
+  char *boardBlock = (char *)board;
+  size_t blockBytes = sizeof(Board<N>);
 
 #ifdef RUN_MIC /* Use RUN_MIC to distinguish between the target of compilation */
 
@@ -1021,56 +338,89 @@ int main(int argc, const char *argv[])
    * Xeon Phi.
    */
 #pragma offload target(mic)  \
-  inout(board: length(boardSize * boardSize) INOUT) 
+  inout(boardBlock: length(blockBytes) INOUT) 
 #endif
   {
     //keep memory location so that memory can be transfered out properly
-    int *temp = board;
+    Board<N> *temp = (Board<N> *)boardBlock;
+    board = temp;
+    if (engine == ENGINE_DLX) {
+      //exact cover search over the choices left by the initial elimination
+      board = dlxSolve(board);
+    }
+    else if (engine == ENGINE_BITBOARD) {
+      //whole 9x9 search on digit planes held by value
+      board = bitboardSolve(board);
+    }
     //Humanistic algorithm
-    if (!humanistic(board, boardSize, n)){
+    else if (!humanistic(board)){
       //no solution exists
       board = NULL;
     } else {
-      BoardStack bStack;
-      bStack.push(board);
+      static BoardDeque<N> deques[MAX_THREADS];
+      static SolutionCounter counters[MAX_THREADS];
+      for (int t = 0; t < num_of_threads; t++) {
+        initDeque(deques[t], 64);
+        counters[t].solutions.store(0);
+      }
+      SearchState<N> state;
+      state.deques = deques;
+      state.outstanding.store(1);
+      state.stop.store(false);
+      state.solution.store(NULL);
+      state.portfolio = (engine == ENGINE_PORTFOLIO);
+      state.winner = -1;
+      state.counting = (countLimit >= 0);
+      state.countLimit = countLimit;
+      state.counters = counters;
+      //the deques only hold pool boards, so that every board taken can be given back
+      if (!state.portfolio) dequePush(deques[0], copyBoard(board));
       printf("Here\n");
-      bool sstop = false;
-      int *tboard;
-      int tn;
       omp_set_num_threads(num_of_threads);
-      omp_lock_t stackLock;
-      omp_init_lock(&stackLock);
-      #pragma omp parallel private(tboard,tn)
+      //propagation and search give up as soon as stop is set
+      cancelToken = &state.stop;
+      #pragma omp parallel copyin(SEARCH_CONFIG)
       {
-        tn = omp_get_thread_num();
-        while (!sstop){
-          tboard = stackedBruteForce(boardSize, n, bStack, stackLock);
-          if (tboard) {
-            sstop = true;
-            board = tboard;
-            #pragma omp flush(sstop)
-            #pragma omp flush(board)
-          }
-        }
+        Trail<N> trail;
+        if (state.portfolio) portfolioSearch(board, state, trail);
+        else stackedBruteForce(state, trail);
+      }
+      cancelToken = NULL;
+      board = state.solution.load();
+      if (state.portfolio) printf("Portfolio winner: thread %d.\n", state.winner);
+      if (state.counting) {
+        //reduce the counters of the threads
+        for (int t = 0; t < num_of_threads; t++) solutionCount += counters[t].solutions.load();
+        limitReached = countLimit && solutionCount >= countLimit;
       }
-      omp_destroy_lock(&stackLock);
+      if (board && !state.counting && get_option_int("-stats", 0)) {
+        printf("Time to exit after the solution: %lf.\n", duration_cast<dsec>(Clock::now() - state.solvedAt).count());
+      }
+      for (int t = 0; t < num_of_threads; t++) destroyDeque(deques[t]);
     }
 
     if (board != NULL) {
-      memcpy(temp, board, boardSize * boardSize * sizeof(int));
+      memcpy(temp, board, blockBytes);
     } else solution = false;
   }
 
-  //printBoard(board, boardSize);
+  //printBoard(board);
 
   compute_time += duration_cast<dsec>(Clock::now() - compute_start).count();
   printf("Computation Time: %lf.\n", compute_time);
+  if (countLimit >= 0) {
+    //the threads may together pass the limit before they see it
+    printf("Solutions: %ld%s.\n", solutionCount, limitReached ? " (limit reached, there may be more)" : "");
+    if (countLimit != 1) printf("Unique: %s.\n", solutionCount == 1 && !limitReached ? "yes" : "no");
+    printf("Solutions per second: %.0lf.\n", solutionCount / compute_time);
+  }
+  if (get_option_int("-stats", 0)) printStrategyStats();
 
   if (!solution) {
     board = NULL;
   }
   
-  correctnessChecker(board, originalBoard, boardSize);
+  correctnessChecker(board, originalBoard);
 
   /* OUTPUT YOUR RESULTS TO FILES HERE */
   char input_filename_cpy[BUFSIZE];
@@ -1087,10 +437,12 @@ int main(int argc, const char *argv[])
   FILE *output_file = fopen(output_filename, "w");
   if (!output_file) {
     printf("Error: couldn't output file");
+    releaseBoards<N>();
+    free(boardBlock);
     return -1;
   }
 
-  fprintf(output_file, "%d\n", n);
+  fprintf(output_file, "%d\n", N);
   
   // WRITE TO FILE HERE
   if (board != NULL) {
@@ -1105,5 +457,133 @@ int main(int argc, const char *argv[])
 
   fclose(output_file);
 
+  //boards of the search, the original included, then the board that was read
+  releaseBoards<N>();
+  free(boardBlock);
   return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, const char *argv[])
+{
+  typedef std::chrono::high_resolution_clock Clock;
+
+  auto init_start = Clock::now();
+ 
+  /* the options are read as name and value pairs, so a -count given
+     without a limit gets the limit 0, counting every solution */
+  std::vector<const char *> args(argv, argv + argc);
+  for (size_t k = 1; k < args.size(); k++) {
+    if (strcmp(args[k], "-count")) continue;
+    const char *next = k + 1 < args.size() ? args[k + 1] : NULL;
+    bool hasLimit = next && !(next[0] == '-' && (next[1] < '0' || next[1] > '9'));
+    if (!hasLimit) args.insert(args.begin() + k + 1, "0");
+  }
+
+  _argc = args.size() - 1;
+  _argv = args.data() + 1;
+
+  /* You'll want to use these parameters in your algorithm */
+  const char *input_filename = get_option_string("-f", NULL);
+  int num_of_threads = get_option_int("-n", 1);
+  const char *engineName = get_option_string("-e", "auto");
+  const char *preset = get_option_string("-preset", "balanced");
+
+  int error = 0;
+
+  int engine = ENGINE_AUTO;
+  if (!strcmp(engineName, "stack")) {
+    engine = ENGINE_STACK;
+  } else if (!strcmp(engineName, "dlx")) {
+    engine = ENGINE_DLX;
+  } else if (!strcmp(engineName, "bitboard")) {
+    engine = ENGINE_BITBOARD;
+  } else if (!strcmp(engineName, "portfolio")) {
+    engine = ENGINE_PORTFOLIO;
+  } else if (strcmp(engineName, "auto")) {
+    printf("Error: Unknown engine %s.\n", engineName);
+    error = 1;
+  }
+  if (!setPreset(preset)) {
+    printf("Error: Unknown preset %s.\n", preset);
+    error = 1;
+  }
+  maxSubsetSize = get_option_int("-k", maxSubsetSize);
+  maxFishSize = get_option_int("-fish", maxFishSize);
+  const char *order = get_option_string("-order", "asc");
+  if (!setValueOrder(order)) {
+    printf("Error: Unknown value order %s.\n", order);
+    error = 1;
+  }
+  randomSeed = get_option_int("-seed", time(NULL));
+  const char *simd = get_option_string("-simd", "auto");
+  if (!setSimd(simd)) {
+    printf("Error: Unknown SIMD level %s.\n", simd);
+    error = 1;
+  }
+
+  if (get_option_int("-count", 0) < 0) {
+    printf("Error: The solution limit of -count must be at least 0.\n");
+    error = 1;
+  }
+
+  if (num_of_threads < 1 || num_of_threads > MAX_THREADS) {
+    printf("Error: The number of threads must be between 1 and %d.\n", MAX_THREADS);
+    error = 1;
+  }
+
+  if (input_filename == NULL) {
+    printf("Error: You need to specify -f.\n");
+    error = 1;
+  }
+
+  if (error) {
+    show_help(argv[0]);
+    return 1;
+  }
+  
+  printf("Number of threads: %d\n", num_of_threads);
+  printf("Input file: %s\n", input_filename);
+  printf("SIMD: %s\n", simdNames[simdLevel]);
+  printf("Value order: %s\n", orderNames[valueOrder]);
+  if (valueOrder == ORDER_RANDOM) printf("Seed: %u\n", randomSeed);
+
+  FILE *input = fopen(input_filename, "r");
+
+  if (!input) {
+    printf("Unable to open file: %s.\n", input_filename);
+    return -1;
+  }
+ 
+  //size of sudoku board is n^2 x n^2
+  int n;
+
+  fscanf(input, "%d\n", &n);
+
+  //only the stack engine goes on searching after a solution
+  bool counting = get_option_int("-count", -1) >= 0;
+  if (engine == ENGINE_AUTO) engine = (n == 3 && !counting) ? ENGINE_BITBOARD : ENGINE_STACK;
+  if (counting && engine != ENGINE_STACK) {
+    printf("Error: -count needs the stack engine.\n");
+    return 1;
+  }
+  if (engine == ENGINE_BITBOARD && n != 3) {
+    printf("Error: The bitboard engine only solves 9x9 boards.\n");
+    return 1;
+  }
+
+  //dispatch to the solver specialized for this board size
+  switch (n) {
+    case 3: return solveSudoku<3>(input, input_filename, num_of_threads, engine, init_start);
+    case 4: return solveSudoku<4>(input, input_filename, num_of_threads, engine, init_start);
+    case 5: return solveSudoku<5>(input, input_filename, num_of_threads, engine, init_start);
+    case 6: return solveSudoku<6>(input, input_filename, num_of_threads, engine, init_start);
+    case 7: return solveSudoku<7>(input, input_filename, num_of_threads, engine, init_start);
+    case 8: return solveSudoku<8>(input, input_filename, num_of_threads, engine, init_start);
+    case 9: return solveSudoku<9>(input, input_filename, num_of_threads, engine, init_start);
+    case 10: return solveSudoku<10>(input, input_filename, num_of_threads, engine, init_start);
+    case 11: return solveSudoku<11>(input, input_filename, num_of_threads, engine, init_start);
+  }
+
+  printf("Unsupported board size: %dx%d.\n", n*n, n*n);
+  return -1;
+}
@@ -0,0 +1,72 @@
+/**
+ * Precomputed unit and peer tables of a Sudoku board
+ * Christopher Shan(cshan1), Omar Shafie(oshafie)
+ *
+ * Units are numbered rows first (0..boardSize-1), then columns, then boxes.
+ * The tables are filled once by Topology<N>::build() before solving, after
+ * which the strategies walk flat index arrays instead of recomputing row,
+ * column and box coordinates with / and %.
+ */
+
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+template <int N>
+struct Topology {
+  static const int boardSize = N * N;
+  static const int totalSquares = boardSize * boardSize;
+  static const int numUnits = 3 * boardSize;
+  //other cells of the row and column, plus the cells of the box not on either
+  static const int numPeers = 2 * (boardSize - 1) + (N - 1) * (N - 1);
+
+  static const int ROW = 0;
+  static const int COL = 1;
+  static const int BOX = 2;
+
+  //cells that share a unit with every cell
+  int peers[totalSquares][numPeers];
+  //row, column and box unit of every cell
+  int cellUnits[totalSquares][3];
+  //cells of every unit, in row-major order
+  int unitCells[numUnits][boardSize];
+
+  static Topology<N> table;
+
+  static void build();
+};
+
+template <int N>
+Topology<N> Topology<N>::table;
+
+template <int N>
+void Topology<N>::build() {
+  Topology<N> &topo = table;
+  for (int i = 0; i < totalSquares; i++) {
+    int row = i / boardSize;
+    int col = i % boardSize;
+    int box = (row / N) * N + col / N;
+    topo.cellUnits[i][ROW] = row;
+    topo.cellUnits[i][COL] = boardSize + col;
+    topo.cellUnits[i][BOX] = 2 * boardSize + box;
+    //position of the cell inside each of its units
+    topo.unitCells[row][col] = i;
+    topo.unitCells[boardSize + col][row] = i;
+    topo.unitCells[2 * boardSize + box][(row % N) * N + col % N] = i;
+  }
+  for (int i = 0; i < totalSquares; i++) {
+    int row = i / boardSize;
+    int col = i % boardSize;
+    int count = 0;
+    for (int j = 0; j < boardSize; j++) {
+      if (j != col) topo.peers[i][count++] = row * boardSize + j;
+      if (j != row) topo.peers[i][count++] = j * boardSize + col;
+    }
+    int box = topo.cellUnits[i][BOX];
+    for (int j = 0; j < boardSize; j++) {
+      int cell = topo.unitCells[box][j];
+      if (cell / boardSize != row && cell % boardSize != col) topo.peers[i][count++] = cell;
+    }
+  }
+}
+
+#endif